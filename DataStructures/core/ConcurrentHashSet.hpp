@@ -0,0 +1,230 @@
+#ifndef CONCURRENTHASHSET_HPP
+#define CONCURRENTHASHSET_HPP
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include "HashSet.hpp"
+#include "Set.hpp"
+
+
+// A ConcurrentHashSet is a HashSet that can be shared safely between
+// threads.  It's split into a number of shards, each of which is an
+// ordinary HashSet protected by its own reader/writer lock, and each
+// element belongs to the shard selected by the high bits of its hash (the
+// low bits are left to pick a bucket within the shard).  Any number of
+// threads can call contains() on the same shard at once, and threads that
+// call add() only wait for other threads working on the same shard, so
+// with enough shards, contention is rare.
+
+template <typename ElementType>
+class ConcurrentHashSet : public Set<ElementType>
+{
+public:
+    // The number of shards used when none is specified.
+    static constexpr unsigned int DEFAULT_SHARD_COUNT = 64;
+
+    // A HashFunction is a function that takes a reference to a const
+    // ElementType and returns an unsigned int.  It will be called from
+    // many threads at once, so it must not modify any shared state, and
+    // its high bits need to be as well-distributed as its low ones, since
+    // they're what choose the shard.
+    using HashFunction = std::function<unsigned int(const ElementType&)>;
+
+public:
+    // Initializes a ConcurrentHashSet to be empty, so that it will use the
+    // given hash function whenever it needs to hash an element.  The
+    // number of shards is rounded up to a power of two.
+    explicit ConcurrentHashSet(
+        HashFunction hashFunction, unsigned int shardCount = DEFAULT_SHARD_COUNT);
+
+    // Cleans up the ConcurrentHashSet so that it leaks no memory.
+    virtual ~ConcurrentHashSet() noexcept = default;
+
+    // A ConcurrentHashSet can be neither copied nor moved, since other
+    // threads may be using it while that happens.
+    ConcurrentHashSet(const ConcurrentHashSet& s) = delete;
+    ConcurrentHashSet& operator=(const ConcurrentHashSet& s) = delete;
+
+
+    // isImplemented() returns true, since a ConcurrentHashSet is fully
+    // implemented.
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the set,
+    // this function has no effect.  Only the shard that the element belongs
+    // to is locked, exclusively, while it runs.
+    virtual void add(const ElementType& element) override;
+
+
+    // remove() removes an element from the set.  If the element isn't in
+    // the set, this function has no effect.  Like add(), it only locks the
+    // shard that the element belongs to.
+    void remove(const ElementType& element);
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  Only the shard that the element belongs to is
+    // locked, and only in shared mode, so it can run alongside any number
+    // of other calls to contains().
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.  If other threads
+    // are adding elements at the same time, the result may already be out
+    // of date when it's returned.
+    virtual unsigned int size() const noexcept override;
+
+
+    // shardCount() returns the number of shards.
+    unsigned int shardCount() const noexcept;
+
+
+    // elementsInShard() returns the number of elements in the given shard.
+    // If the shard doesn't exist, this function returns 0.
+    unsigned int elementsInShard(unsigned int shard) const;
+
+
+private:
+    // Each shard is aligned to its own cache line, so that threads locking
+    // neighbouring shards don't slow each other down.
+    struct alignas(64) Shard
+    {
+        mutable std::shared_mutex mutex;
+        HashSet<ElementType> set;
+
+        explicit Shard(HashFunction hashFunction);
+    };
+
+    HashFunction hashFunction;
+    std::vector<std::unique_ptr<Shard>> shards;
+    unsigned int shardBits;
+    std::atomic<unsigned int> sz;
+
+
+private:
+    Shard& shardFor(const ElementType& element) const;
+};
+
+
+
+template <typename ElementType>
+ConcurrentHashSet<ElementType>::Shard::Shard(HashFunction hashFunction)
+    : set{hashFunction}
+{
+}
+
+
+template <typename ElementType>
+ConcurrentHashSet<ElementType>::ConcurrentHashSet(
+    HashFunction hashFunction, unsigned int shardCount)
+    : hashFunction{hashFunction}, shardBits{0}, sz{0}
+{
+    while ((1u << shardBits) < shardCount && shardBits < 16)
+    {
+        ++shardBits;
+    }
+
+    for (unsigned int i = 0; i < (1u << shardBits); ++i)
+    {
+        shards.push_back(std::make_unique<Shard>(hashFunction));
+    }
+}
+
+
+template <typename ElementType>
+bool ConcurrentHashSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::add(const ElementType& element)
+{
+    Shard& shard = shardFor(element);
+    std::unique_lock<std::shared_mutex> lock{shard.mutex};
+
+    unsigned int oldSize = shard.set.size();
+    shard.set.add(element);
+
+    if (shard.set.size() != oldSize)
+    {
+        sz.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::remove(const ElementType& element)
+{
+    Shard& shard = shardFor(element);
+    std::unique_lock<std::shared_mutex> lock{shard.mutex};
+
+    unsigned int oldSize = shard.set.size();
+    shard.set.remove(element);
+
+    if (shard.set.size() != oldSize)
+    {
+        sz.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+
+template <typename ElementType>
+bool ConcurrentHashSet<ElementType>::contains(const ElementType& element) const
+{
+    Shard& shard = shardFor(element);
+    std::shared_lock<std::shared_mutex> lock{shard.mutex};
+
+    return shard.set.contains(element);
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentHashSet<ElementType>::size() const noexcept
+{
+    return sz.load(std::memory_order_relaxed);
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentHashSet<ElementType>::shardCount() const noexcept
+{
+    return shards.size();
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentHashSet<ElementType>::elementsInShard(unsigned int shard) const
+{
+    if (shard >= shards.size())
+    {
+        return 0;
+    }
+
+    std::shared_lock<std::shared_mutex> lock{shards[shard]->mutex};
+    return shards[shard]->set.size();
+}
+
+
+template <typename ElementType>
+typename ConcurrentHashSet<ElementType>::Shard& ConcurrentHashSet<ElementType>::shardFor(
+    const ElementType& element) const
+{
+    if (shardBits == 0)
+    {
+        return *shards[0];
+    }
+
+    return *shards[hashFunction(element) >> (sizeof(unsigned int) * 8 - shardBits)];
+}
+
+
+
+#endif // CONCURRENTHASHSET_HPP
+
@@ -0,0 +1,447 @@
+#ifndef CUCKOOHASHSET_HPP
+#define CUCKOOHASHSET_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Hashing.hpp"
+#include "Set.hpp"
+
+
+// A CuckooHashSet is a hash set with a bounded worst case for lookups,
+// using "bucketized cuckoo hashing."  Each element is hashed by two
+// different hash functions, which select two buckets of BUCKET_WIDTH
+// slots each, and the element is always stored in one of those two
+// buckets.  So contains() examines at most 2 * BUCKET_WIDTH slots, no
+// matter how unlucky the hashes are, and since each bucket starts on its
+// own cache line with its elements' hashes first, finding out which (if
+// any) slot to compare against touches at most two cache lines.
+//
+// When add() finds both buckets full, it moves ("kicks out") an element
+// of one of them to that element's other bucket, which may kick out
+// another, and so on.  In the rare case that this goes on for MAX_KICKS
+// moves, the element left over goes into a small "stash" instead, which
+// contains() also searches; a stash that grows past STASH_SIZE triggers
+// a resize.  The stash only stays larger than that when many distinct
+// elements have identical hashes under both hash functions, which no
+// arrangement of buckets could fix.
+//
+// ElementType must be default-constructible, since empty slots still hold
+// an (unused) element.
+
+namespace impl_
+{
+    // CuckooHashSet__SecondHasher<ElementType> is the default second hash
+    // function.  It hashes like DefaultHasher (see Hashing.hpp), but with
+    // a seed, so that it's independent of DefaultHasher,
+    // hashing::hashString(), and hashing::hashInteger(), which are the
+    // first hash functions that callers are most likely to supply.
+    constexpr std::uint64_t CuckooHashSet__SEED = 0x9e3779b97f4a7c15ull;
+
+
+    template <typename ElementType>
+    struct CuckooHashSet__SecondHasher
+    {
+        unsigned int operator()(const ElementType& element) const noexcept
+        {
+            if constexpr (std::is_integral<ElementType>::value || std::is_enum<ElementType>::value)
+            {
+                return hashing::fold(hashing::mixInteger(
+                    static_cast<std::uint64_t>(element) ^ CuckooHashSet__SEED));
+            }
+            else
+            {
+                return hashing::fold(hashing::mixInteger(
+                    std::hash<ElementType>{}(element) ^ CuckooHashSet__SEED));
+            }
+        }
+    };
+
+
+    template <>
+    struct CuckooHashSet__SecondHasher<std::string>
+    {
+        unsigned int operator()(const std::string& element) const noexcept
+        {
+            return hashing::fold(
+                hashing::hashBytes(element.data(), element.size(), CuckooHashSet__SEED));
+        }
+    };
+}
+
+
+
+template <typename ElementType>
+class CuckooHashSet : public Set<ElementType>
+{
+public:
+    // The number of slots in each bucket.
+    static constexpr unsigned int BUCKET_WIDTH = 4;
+
+    // The number of buckets in a CuckooHashSet before anything has been
+    // added to it.  Bucket counts are always a power of two.
+    static constexpr unsigned int DEFAULT_BUCKET_COUNT = 4;
+
+    // The most elements that add() moves before giving up and using the
+    // stash, and the most elements the stash is meant to hold.
+    static constexpr unsigned int MAX_KICKS = 256;
+    static constexpr unsigned int STASH_SIZE = 4;
+
+    // A HashFunction is a function that takes a reference to a const
+    // ElementType and returns an unsigned int.
+    using HashFunction = std::function<unsigned int(const ElementType&)>;
+
+public:
+    // Initializes a CuckooHashSet to be empty, so that it will use the two
+    // given hash functions to choose each element's buckets.  The second
+    // defaults to a seeded variant of DefaultHasher (see Hashing.hpp), so
+    // that elements that are skewed or colliding under the first, even
+    // when the first is DefaultHasher itself, are still spread out by the
+    // second.
+    explicit CuckooHashSet(
+        HashFunction hashFunction,
+        HashFunction secondHashFunction = impl_::CuckooHashSet__SecondHasher<ElementType>{});
+
+    // A CuckooHashSet can be copied, moved, and assigned like any other
+    // set; the default versions of these do the right thing.
+    virtual ~CuckooHashSet() noexcept = default;
+    CuckooHashSet(const CuckooHashSet& s) = default;
+    CuckooHashSet(CuckooHashSet&& s) noexcept = default;
+    CuckooHashSet& operator=(const CuckooHashSet& s) = default;
+    CuckooHashSet& operator=(CuckooHashSet&& s) noexcept = default;
+
+
+    // isImplemented() returns true, since a CuckooHashSet is fully
+    // implemented.
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the set,
+    // this function has no effect.  This function triggers a resizing of the
+    // buckets when the ratio of size to capacity would exceed 0.9, or when
+    // the stash overflows.  It runs in amortized constant time (assuming
+    // good hash functions).
+    virtual void add(const ElementType& element) override;
+
+
+    // remove() removes an element from the set.  If the element isn't in
+    // the set, this function has no effect.  The last element of its
+    // bucket is moved into its slot, so buckets never have holes, and like
+    // contains(), this function runs in constant time.
+    void remove(const ElementType& element);
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  It examines at most two buckets and the stash, so
+    // it runs in constant time even in the worst case (unless many
+    // elements have identical hashes under both hash functions).
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // bucketCount() returns the number of buckets.
+    unsigned int bucketCount() const noexcept;
+
+
+    // stashSize() returns the number of elements in the stash.
+    unsigned int stashSize() const noexcept;
+
+
+private:
+    // Each bucket holds both hashes of each of its elements: the first is
+    // compared during lookups, and both are needed to find an element's
+    // other bucket when it's kicked out.
+    struct alignas(64) Bucket
+    {
+        unsigned int firstHashes[BUCKET_WIDTH];
+        unsigned int secondHashes[BUCKET_WIDTH];
+        unsigned int count;
+        ElementType elements[BUCKET_WIDTH];
+
+        Bucket();
+    };
+
+    struct Stashed
+    {
+        unsigned int firstHash;
+        ElementType element;
+    };
+
+    HashFunction hashFunction;
+    HashFunction secondHashFunction;
+    std::vector<Bucket> buckets;
+    std::vector<Stashed> stash;
+    unsigned int stashLimit;
+    unsigned int sz;
+    unsigned int kickSeed;
+
+
+private:
+    bool bucketContains(
+        const Bucket& bucket, const ElementType& element, unsigned int firstHash) const;
+    bool insert(ElementType& element, unsigned int& firstHash, unsigned int& secondHash);
+    void resize(unsigned int newBucketCount);
+};
+
+
+
+template <typename ElementType>
+CuckooHashSet<ElementType>::Bucket::Bucket()
+    : count{0}
+{
+}
+
+
+template <typename ElementType>
+CuckooHashSet<ElementType>::CuckooHashSet(
+    HashFunction hashFunction, HashFunction secondHashFunction)
+    : hashFunction{hashFunction}, secondHashFunction{secondHashFunction},
+      buckets(DEFAULT_BUCKET_COUNT), stashLimit{STASH_SIZE}, sz{0}, kickSeed{0}
+{
+}
+
+
+template <typename ElementType>
+bool CuckooHashSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void CuckooHashSet<ElementType>::add(const ElementType& element)
+{
+    if (contains(element))
+    {
+        return;
+    }
+
+    if (sz + 1 > buckets.size() * BUCKET_WIDTH / 10 * 9)
+    {
+        resize(buckets.size() * 2);
+    }
+
+    ElementType leftover = element;
+    unsigned int firstHash = hashFunction(element);
+    unsigned int secondHash = secondHashFunction(element);
+
+    if (!insert(leftover, firstHash, secondHash))
+    {
+        stash.push_back(Stashed{firstHash, std::move(leftover)});
+    }
+
+    ++sz;
+
+    // Resizing puts most of the stash back into buckets.  If it doesn't,
+    // the limit is raised, so that elements with identical hashes can't
+    // make every subsequent add() resize again.
+    if (stash.size() > stashLimit)
+    {
+        resize(buckets.size() * 2);
+        stashLimit = std::max<unsigned int>(stashLimit, stash.size() * 2);
+    }
+}
+
+
+template <typename ElementType>
+void CuckooHashSet<ElementType>::remove(const ElementType& element)
+{
+    unsigned int firstHash = hashFunction(element);
+    unsigned int secondHash = secondHashFunction(element);
+    unsigned int mask = buckets.size() - 1;
+
+    for (unsigned int index : {firstHash & mask, secondHash & mask})
+    {
+        Bucket& bucket = buckets[index];
+
+        for (unsigned int i = 0; i < bucket.count; ++i)
+        {
+            if (bucket.firstHashes[i] == firstHash && bucket.elements[i] == element)
+            {
+                unsigned int last = bucket.count - 1;
+                bucket.firstHashes[i] = bucket.firstHashes[last];
+                bucket.secondHashes[i] = bucket.secondHashes[last];
+                bucket.elements[i] = std::move(bucket.elements[last]);
+                bucket.elements[last] = ElementType{};
+                --bucket.count;
+                --sz;
+                return;
+            }
+        }
+    }
+
+    for (auto i = stash.begin(); i != stash.end(); ++i)
+    {
+        if (i->firstHash == firstHash && i->element == element)
+        {
+            stash.erase(i);
+            --sz;
+            return;
+        }
+    }
+}
+
+
+template <typename ElementType>
+bool CuckooHashSet<ElementType>::contains(const ElementType& element) const
+{
+    unsigned int firstHash = hashFunction(element);
+    unsigned int mask = buckets.size() - 1;
+
+    if (bucketContains(buckets[firstHash & mask], element, firstHash))
+    {
+        return true;
+    }
+
+    unsigned int secondHash = secondHashFunction(element);
+
+    if (bucketContains(buckets[secondHash & mask], element, firstHash))
+    {
+        return true;
+    }
+
+    for (const Stashed& stashed : stash)
+    {
+        if (stashed.firstHash == firstHash && stashed.element == element)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+template <typename ElementType>
+unsigned int CuckooHashSet<ElementType>::size() const noexcept
+{
+    return sz;
+}
+
+
+template <typename ElementType>
+unsigned int CuckooHashSet<ElementType>::bucketCount() const noexcept
+{
+    return buckets.size();
+}
+
+
+template <typename ElementType>
+unsigned int CuckooHashSet<ElementType>::stashSize() const noexcept
+{
+    return stash.size();
+}
+
+
+template <typename ElementType>
+bool CuckooHashSet<ElementType>::bucketContains(
+    const Bucket& bucket, const ElementType& element, unsigned int firstHash) const
+{
+    for (unsigned int i = 0; i < bucket.count; ++i)
+    {
+        if (bucket.firstHashes[i] == firstHash && bucket.elements[i] == element)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+// insert() places an element into one of its buckets, kicking out other
+// elements as necessary.  If it gives up, it returns false, leaving
+// whichever element it was holding at the time (not necessarily the one
+// it was given) in element, firstHash, and secondHash.
+template <typename ElementType>
+bool CuckooHashSet<ElementType>::insert(
+    ElementType& element, unsigned int& firstHash, unsigned int& secondHash)
+{
+    unsigned int mask = buckets.size() - 1;
+    unsigned int index = firstHash & mask;
+
+    for (unsigned int kicks = 0; kicks <= MAX_KICKS; ++kicks)
+    {
+        unsigned int other = (secondHash & mask) == index ? firstHash & mask : secondHash & mask;
+
+        // Prefer whichever of the two buckets has room.
+        if (buckets[index].count == BUCKET_WIDTH && buckets[other].count < BUCKET_WIDTH)
+        {
+            std::swap(index, other);
+        }
+
+        Bucket& bucket = buckets[index];
+
+        if (bucket.count < BUCKET_WIDTH)
+        {
+            bucket.firstHashes[bucket.count] = firstHash;
+            bucket.secondHashes[bucket.count] = secondHash;
+            bucket.elements[bucket.count] = std::move(element);
+            ++bucket.count;
+            return true;
+        }
+
+        if (kicks == MAX_KICKS)
+        {
+            break;
+        }
+
+        // Both buckets are full, so swap the element with one chosen
+        // pseudo-randomly from this bucket, then place that one in its
+        // other bucket.  Choosing randomly keeps the kicks from cycling.
+        kickSeed = kickSeed * 1103515245u + 12345u;
+        unsigned int victim = (kickSeed >> 16) % BUCKET_WIDTH;
+
+        std::swap(element, bucket.elements[victim]);
+        std::swap(firstHash, bucket.firstHashes[victim]);
+        std::swap(secondHash, bucket.secondHashes[victim]);
+
+        index = (firstHash & mask) == index ? secondHash & mask : firstHash & mask;
+    }
+
+    return false;
+}
+
+
+template <typename ElementType>
+void CuckooHashSet<ElementType>::resize(unsigned int newBucketCount)
+{
+    std::vector<Bucket> oldBuckets(newBucketCount);
+    std::swap(buckets, oldBuckets);
+
+    std::vector<Stashed> oldStash;
+    std::swap(stash, oldStash);
+
+    auto reinsert = [this](ElementType& element, unsigned int firstHash, unsigned int secondHash) {
+        if (!insert(element, firstHash, secondHash))
+        {
+            stash.push_back(Stashed{firstHash, std::move(element)});
+        }
+    };
+
+    for (Bucket& bucket : oldBuckets)
+    {
+        for (unsigned int i = 0; i < bucket.count; ++i)
+        {
+            reinsert(bucket.elements[i], bucket.firstHashes[i], bucket.secondHashes[i]);
+        }
+    }
+
+    // Stashed elements don't keep their second hash, since lookups never
+    // need it, so it's computed again here.
+    for (Stashed& stashed : oldStash)
+    {
+        reinsert(stashed.element, stashed.firstHash, secondHashFunction(stashed.element));
+    }
+}
+
+
+
+#endif // CUCKOOHASHSET_HPP
@@ -0,0 +1,406 @@
+#ifndef FROZENHASHSET_HPP
+#define FROZENHASHSET_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Hashing.hpp"
+#include "HashSet.hpp"
+#include "Set.hpp"
+
+
+// A FrozenHashSet is a hash set whose contents are fixed when it's built,
+// for read-only data like a dictionary that's loaded once and then only
+// ever searched.  Knowing every element in advance, it builds a minimal
+// perfect hash function for them (using the "compress, hash, displace"
+// algorithm): one that maps each of its n elements to a different index
+// between 0 and n - 1.  The elements are stored in a single array at
+// exactly those indexes, so contains() hashes its argument, reads one
+// pair of displacements, and compares against exactly one element; there
+// are no chains, no probing, and no empty slots.
+//
+// The elements are hashed into 64-bit values, so that there's no real
+// chance of two distinct elements having the same hash (which would make
+// it impossible to separate them).
+//
+// Since the set can't change, add() throws a std::logic_error.
+
+namespace impl_
+{
+    template <typename ElementType>
+    std::uint64_t FrozenHashSet__defaultHash(const ElementType& element)
+    {
+        if constexpr (std::is_convertible<const ElementType&, std::string_view>::value)
+        {
+            std::string_view bytes = element;
+            return hashing::hashBytes(bytes.data(), bytes.size());
+        }
+        else if constexpr (std::is_integral<ElementType>::value || std::is_enum<ElementType>::value)
+        {
+            return hashing::mixInteger(static_cast<std::uint64_t>(element));
+        }
+        else
+        {
+            return hashing::mixInteger(std::hash<ElementType>{}(element));
+        }
+    }
+}
+
+
+
+template <typename ElementType>
+class FrozenHashSet : public Set<ElementType>
+{
+public:
+    // The average number of elements per bucket of the perfect hash
+    // function.  Each bucket costs eight bytes, so larger buckets make a
+    // smaller set that takes longer to build.
+    static constexpr unsigned int ELEMENTS_PER_BUCKET = 4;
+
+    // A HashFunction is a function that takes a reference to a const
+    // ElementType and returns a 64-bit hash.  Distinct elements must have
+    // distinct hashes.
+    using HashFunction = std::function<std::uint64_t(const ElementType&)>;
+
+public:
+    // Initializes a FrozenHashSet containing the given elements (any that
+    // appear more than once are only stored once).  If two distinct
+    // elements have the same hash, std::invalid_argument is thrown.
+    explicit FrozenHashSet(
+        const std::vector<ElementType>& elements,
+        HashFunction hashFunction = impl_::FrozenHashSet__defaultHash<ElementType>);
+
+    // Initializes a FrozenHashSet containing the elements of a HashSet.
+    template <typename Hasher>
+    explicit FrozenHashSet(
+        const HashSet<ElementType, Hasher>& s,
+        HashFunction hashFunction = impl_::FrozenHashSet__defaultHash<ElementType>);
+
+    // A FrozenHashSet can be copied, moved, and assigned like any other
+    // set; the default versions of these do the right thing.
+    virtual ~FrozenHashSet() noexcept = default;
+    FrozenHashSet(const FrozenHashSet& s) = default;
+    FrozenHashSet(FrozenHashSet&& s) noexcept = default;
+    FrozenHashSet& operator=(const FrozenHashSet& s) = default;
+    FrozenHashSet& operator=(FrozenHashSet&& s) noexcept = default;
+
+
+    // isImplemented() returns true, since a FrozenHashSet is fully
+    // implemented.
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() throws a std::logic_error, since a FrozenHashSet can't be
+    // changed after it's built.
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is in the set, false
+    // otherwise.  It compares the given element against exactly one
+    // element of the set, so it runs in constant time, even in the worst
+    // case.
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // bucketCount() returns the number of buckets in the perfect hash
+    // function, each of which stores one pair of displacements.
+    unsigned int bucketCount() const noexcept;
+
+
+private:
+    // Each bucket's elements are placed at the indexes
+    //
+    //     (first + displacement0 * second + displacement1) % size
+    //
+    // where first and second are derived from each element's hash.
+    struct Displacement
+    {
+        std::uint32_t displacement0;
+        std::uint32_t displacement1;
+    };
+
+    // The values derived from one element's hash while the set is built.
+    struct Key
+    {
+        std::uint64_t hash;
+        std::uint32_t bucket;
+        std::uint32_t first;
+        std::uint32_t second;
+        std::uint32_t source;
+    };
+
+    HashFunction hashFunction;
+    std::uint64_t seed;
+    std::uint32_t count;
+    std::vector<Displacement> displacements;
+    std::vector<ElementType> slots;
+
+
+private:
+    void build(const std::vector<ElementType>& elements);
+    bool tryBuild(std::vector<Key>& keys, const std::vector<ElementType>& elements);
+    Key keyFor(std::uint64_t hash, std::uint32_t source) const noexcept;
+    std::uint32_t slotFor(const Key& key, const Displacement& displacement) const noexcept;
+};
+
+
+
+template <typename ElementType>
+FrozenHashSet<ElementType>::FrozenHashSet(
+    const std::vector<ElementType>& elements, HashFunction hashFunction)
+    : hashFunction{hashFunction}, seed{0}, count{0}
+{
+    build(elements);
+}
+
+
+template <typename ElementType>
+template <typename Hasher>
+FrozenHashSet<ElementType>::FrozenHashSet(
+    const HashSet<ElementType, Hasher>& s, HashFunction hashFunction)
+    : FrozenHashSet{s.elements(), hashFunction}
+{
+}
+
+
+template <typename ElementType>
+bool FrozenHashSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void FrozenHashSet<ElementType>::add(const ElementType&)
+{
+    throw std::logic_error{"a FrozenHashSet cannot be modified"};
+}
+
+
+template <typename ElementType>
+bool FrozenHashSet<ElementType>::contains(const ElementType& element) const
+{
+    if (slots.empty())
+    {
+        return false;
+    }
+
+    Key key = keyFor(hashFunction(element), 0);
+    return slots[slotFor(key, displacements[key.bucket])] == element;
+}
+
+
+template <typename ElementType>
+unsigned int FrozenHashSet<ElementType>::size() const noexcept
+{
+    return slots.size();
+}
+
+
+template <typename ElementType>
+unsigned int FrozenHashSet<ElementType>::bucketCount() const noexcept
+{
+    return displacements.size();
+}
+
+
+template <typename ElementType>
+void FrozenHashSet<ElementType>::build(const std::vector<ElementType>& elements)
+{
+    std::vector<Key> keys;
+    keys.reserve(elements.size());
+
+    for (std::uint32_t i = 0; i < elements.size(); ++i)
+    {
+        keys.push_back(Key{hashFunction(elements[i]), 0, 0, 0, i});
+    }
+
+    // Duplicates are found by sorting on the hashes; equal hashes are
+    // either the same element twice, which is dropped, or a collision.
+    std::sort(
+        keys.begin(), keys.end(),
+        [](const Key& a, const Key& b) { return a.hash < b.hash; });
+
+    std::size_t unique = 0;
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+        if (unique > 0 && keys[unique - 1].hash == keys[i].hash)
+        {
+            if (!(elements[keys[unique - 1].source] == elements[keys[i].source]))
+            {
+                throw std::invalid_argument{"two elements of a FrozenHashSet have the same hash"};
+            }
+        }
+        else
+        {
+            keys[unique++] = keys[i];
+        }
+    }
+
+    keys.resize(unique);
+
+    // Building can fail when two elements in the same bucket end up with
+    // the same first and second values, which no displacements separate;
+    // that's rare, and trying again with a different seed fixes it.
+    while (!tryBuild(keys, elements))
+    {
+        ++seed;
+    }
+}
+
+
+template <typename ElementType>
+bool FrozenHashSet<ElementType>::tryBuild(
+    std::vector<Key>& keys, const std::vector<ElementType>& elements)
+{
+    std::uint32_t n = keys.size();
+    std::uint32_t bucketTotal = (n + ELEMENTS_PER_BUCKET - 1) / ELEMENTS_PER_BUCKET;
+
+    count = n;
+    displacements.assign(std::max<std::uint32_t>(bucketTotal, 1), Displacement{0, 0});
+    slots.clear();
+
+    if (n == 0)
+    {
+        return true;
+    }
+
+    for (Key& key : keys)
+    {
+        key = keyFor(key.hash, key.source);
+    }
+
+    // Group the keys by bucket, then place the largest buckets first,
+    // while there's still plenty of room for them.
+    std::sort(
+        keys.begin(), keys.end(),
+        [](const Key& a, const Key& b) { return a.bucket < b.bucket; });
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> buckets;
+    for (std::uint32_t i = 0; i < n; )
+    {
+        std::uint32_t j = i;
+        while (j < n && keys[j].bucket == keys[i].bucket)
+        {
+            ++j;
+        }
+        buckets.emplace_back(i, j);
+        i = j;
+    }
+
+    std::stable_sort(
+        buckets.begin(), buckets.end(),
+        [](const auto& a, const auto& b) { return a.second - a.first > b.second - b.first; });
+
+    std::vector<std::int64_t> placed(n, -1);
+    std::vector<std::uint32_t> tried;
+    std::uint32_t nextFree = 0;
+
+    for (auto [begin, end] : buckets)
+    {
+        Displacement& displacement = displacements[keys[begin].bucket];
+
+        if (end - begin == 1)
+        {
+            // A bucket with one element can go straight into any free
+            // slot, by choosing displacement1 to land on it.
+            while (placed[nextFree] != -1)
+            {
+                ++nextFree;
+            }
+
+            const Key& key = keys[begin];
+            displacement.displacement1 = (nextFree + n - key.first) % n;
+            placed[nextFree] = key.source;
+            continue;
+        }
+
+        bool found = false;
+
+        for (std::uint32_t d0 = 0; d0 < n && !found; ++d0)
+        {
+            for (std::uint32_t d1 = 0; d1 < n && !found; ++d1)
+            {
+                displacement = Displacement{d0, d1};
+                tried.clear();
+
+                for (std::uint32_t i = begin; i < end; ++i)
+                {
+                    std::uint32_t slot = slotFor(keys[i], displacement);
+
+                    if (placed[slot] != -1
+                        || std::find(tried.begin(), tried.end(), slot) != tried.end())
+                    {
+                        break;
+                    }
+
+                    tried.push_back(slot);
+                }
+
+                found = tried.size() == end - begin;
+            }
+        }
+
+        if (!found)
+        {
+            return false;
+        }
+
+        for (std::uint32_t i = begin; i < end; ++i)
+        {
+            placed[tried[i - begin]] = keys[i].source;
+        }
+    }
+
+    slots.reserve(n);
+    for (std::int64_t source : placed)
+    {
+        slots.push_back(elements[source]);
+    }
+
+    return true;
+}
+
+
+template <typename ElementType>
+typename FrozenHashSet<ElementType>::Key FrozenHashSet<ElementType>::keyFor(
+    std::uint64_t hash, std::uint32_t source) const noexcept
+{
+    // The bucket comes from the high bits of the hash, and first and
+    // second from a remix of the whole thing, so that they're independent.
+    // Values are scaled into range with a multiplication rather than a
+    // (much slower) division.
+    std::uint64_t mixed = hashing::mixInteger(hash ^ (seed * 0x9e3779b97f4a7c15ull));
+
+    Key key;
+    key.hash = hash;
+    key.bucket = static_cast<std::uint32_t>(((hash >> 32) * displacements.size()) >> 32);
+    key.first = static_cast<std::uint32_t>((static_cast<std::uint32_t>(mixed) * std::uint64_t{count}) >> 32);
+    key.second = static_cast<std::uint32_t>(((mixed >> 32) * count) >> 32);
+    key.source = source;
+    return key;
+}
+
+
+template <typename ElementType>
+std::uint32_t FrozenHashSet<ElementType>::slotFor(
+    const Key& key, const Displacement& displacement) const noexcept
+{
+    std::uint64_t slot = key.first
+        + static_cast<std::uint64_t>(displacement.displacement0) * key.second
+        + displacement.displacement1;
+
+    return static_cast<std::uint32_t>(slot % count);
+}
+
+
+#endif // FROZENHASHSET_HPP
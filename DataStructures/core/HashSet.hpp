@@ -3,13 +3,493 @@
 #ifndef HASHSET_HPP
 #define HASHSET_HPP
 
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "BloomFilter.hpp"
+#include "Hashing.hpp"
+#include "NodePool.hpp"
 #include "Set.hpp"
 #include <iostream>
 #include <algorithm>
 
 
+
+// HASHSET_COUNT_PROBES determines whether every HashSet counts the calls
+// to contains() and the nodes they examine, for stats() to report.  The
+// counters are relaxed atomics on a cache line of their own, so they
+// never slow down lookups by sharing a line with the table, but every
+// contains() still writes to them, and threads searching the same set at
+// once contend for that line.  So they're compiled out, and take up no
+// space in a HashSet, unless HASHSET_COUNT_PROBES is defined as 1, which
+// should be done for the whole program (e.g., with
+// -DHASHSET_COUNT_PROBES=1), not just before including this file in some
+// places.
+
+#ifndef HASHSET_COUNT_PROBES
+#define HASHSET_COUNT_PROBES 0
+#endif
+
+
+
+// HashSetStats is a snapshot of the shape of a HashSet, returned by its
+// stats() member function.  The chain lengths are those of the buckets
+// that aren't empty, so that they describe what a search actually has to
+// walk through.
+
+struct HashSetStats
+{
+    unsigned int size;
+    unsigned int bucketCount;
+    double loadFactor;
+    double emptyBucketRatio;
+    double meanChainLength;
+    unsigned int p99ChainLength;
+    unsigned int maxChainLength;
+
+    // The number of buckets of the old array that have yet to be moved,
+    // while an incremental resize is in progress; otherwise, 0.
+    unsigned int bucketsToMove;
+
+    // The number of times the array has been resized, and the number of
+    // calls to contains() (counting each element of a containsBatch()) and
+    // of nodes they examined.  The last two are always 0 when
+    // HASHSET_COUNT_PROBES is 0.
+    std::uint64_t resizes;
+    std::uint64_t lookups;
+    std::uint64_t probes;
+};
+
+
+
+// HashSetCachesHash determines, at compile time, whether a HashSet stores
+// each element's full hash alongside it.  When it does, resizing never has
+// to call the hash function again, and comparisons against the other
+// elements in a bucket are skipped unless their hashes match, which avoids
+// most comparisons of long strings.  For scalar types (integers, pointers,
+// and so on), hashing and comparing are already as cheap as comparing the
+// hashes would be, so it's turned off by default; specialize this template
+// to choose differently for a particular type.
+
+template <typename ElementType>
+struct HashSetCachesHash
+{
+    static constexpr bool value = !std::is_scalar<ElementType>::value;
+};
+
+
+
+// HashSetKeyView determines the type of a lightweight "view" of an element
+// that a HashSet can be searched for without constructing an ElementType.
+// For most types, that's just a reference to a const ElementType, but for
+// std::string, it's a std::string_view, so that a HashSet<std::string>
+// can be searched for a std::string_view or a const char* without
+// allocating a std::string.
+
+template <typename ElementType>
+struct HashSetKeyView
+{
+    using type = const ElementType&;
+};
+
+
+template <>
+struct HashSetKeyView<std::string>
+{
+    using type = std::string_view;
+};
+
+
+
+namespace impl_
+{
+    // HashSet__isTransparent<T>::value is true when T declares a member
+    // type named is_transparent, which is how a hasher announces that it
+    // can hash a KeyView as well as an ElementType.
+    template <typename T, typename = void>
+    struct HashSet__isTransparent : std::false_type
+    {
+    };
+
+
+    template <typename T>
+    struct HashSet__isTransparent<T, std::void_t<typename T::is_transparent>>
+        : std::true_type
+    {
+    };
+
+
+    // HashSet__Counters<true> holds the counters that contains() updates
+    // when HASHSET_COUNT_PROBES is 1.  They're atomic, since contains() may
+    // be called on several threads at once, but copying them copies their
+    // current values.  They fill a cache line of their own, so that
+    // updating them never invalidates the line holding the rest of the
+    // HashSet, which every lookup reads.
+    template <bool Counting>
+    struct alignas(64) HashSet__Counters
+    {
+        std::atomic<std::uint64_t> lookups{0};
+        std::atomic<std::uint64_t> probes{0};
+
+        HashSet__Counters() = default;
+
+        HashSet__Counters(const HashSet__Counters& counters)
+            : lookups{counters.lookups.load(std::memory_order_relaxed)},
+              probes{counters.probes.load(std::memory_order_relaxed)}
+        {
+        }
+
+        HashSet__Counters& operator=(const HashSet__Counters& counters)
+        {
+            lookups.store(counters.lookups.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            probes.store(counters.probes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+
+        void count(unsigned int newLookups, unsigned int newProbes) noexcept
+        {
+            lookups.fetch_add(newLookups, std::memory_order_relaxed);
+            probes.fetch_add(newProbes, std::memory_order_relaxed);
+        }
+
+        std::uint64_t lookupCount() const noexcept
+        {
+            return lookups.load(std::memory_order_relaxed);
+        }
+
+        std::uint64_t probeCount() const noexcept
+        {
+            return probes.load(std::memory_order_relaxed);
+        }
+    };
+
+
+    // HashSet__Counters<false> counts nothing and holds nothing, so that a
+    // HashSet that isn't counting pays neither for the counters' storage
+    // nor for their alignment.
+    template <>
+    struct HashSet__Counters<false>
+    {
+        void count(unsigned int, unsigned int) noexcept
+        {
+        }
+
+        std::uint64_t lookupCount() const noexcept
+        {
+            return 0;
+        }
+
+        std::uint64_t probeCount() const noexcept
+        {
+            return 0;
+        }
+    };
+
+
+    // HashSet__FilterCounters holds the counts that bloomFilterStats()
+    // reports.  Like HashSet__Counters, they're atomic but copyable.  They
+    // live in the HashSet rather than in its BloomFilter, since copies of
+    // a HashSet share one filter but each counts its own searches.
+    struct HashSet__FilterCounters
+    {
+        std::atomic<std::uint64_t> rejections{0};
+        std::atomic<std::uint64_t> falsePositives{0};
+
+        HashSet__FilterCounters() = default;
+
+        HashSet__FilterCounters(const HashSet__FilterCounters& counters)
+            : rejections{counters.rejections.load(std::memory_order_relaxed)},
+              falsePositives{counters.falsePositives.load(std::memory_order_relaxed)}
+        {
+        }
+
+        HashSet__FilterCounters& operator=(const HashSet__FilterCounters& counters)
+        {
+            rejections.store(counters.rejections.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            falsePositives.store(
+                counters.falsePositives.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+
+        void countRejection() noexcept
+        {
+            rejections.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void countFalsePositive() noexcept
+        {
+            falsePositives.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        BloomFilterStats stats() const noexcept
+        {
+            return BloomFilterStats{
+                rejections.load(std::memory_order_relaxed),
+                falsePositives.load(std::memory_order_relaxed)};
+        }
+    };
+
+
+    // HashSet__inParallel() calls function(begin, end) for consecutive
+    // slices that together cover the indexes from 0 up to count, each on
+    // its own thread except the last, which runs on the calling thread.  It
+    // uses no more threads than there are hardware threads, and none whose
+    // slice would be shorter than minPerThread.  Once every slice is done,
+    // the first exception thrown by any of them, if there was one, is
+    // rethrown.
+    template <typename Function>
+    void HashSet__inParallel(unsigned int count, unsigned int minPerThread, Function function)
+    {
+        unsigned int threadCount = std::min(
+            std::max(std::thread::hardware_concurrency(), 1u),
+            std::max(count / minPerThread, 1u));
+
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> errors(threadCount);
+        unsigned int begin = 0;
+
+        try
+        {
+            for (unsigned int t = 0; t + 1 < threadCount; ++t)
+            {
+                unsigned int end = static_cast<unsigned long long>(count) * (t + 1) / threadCount;
+
+                threads.emplace_back([&function, &errors, t, begin, end]() {
+                    try
+                    {
+                        function(begin, end);
+                    }
+                    catch (...)
+                    {
+                        errors[t] = std::current_exception();
+                    }
+                });
+
+                begin = end;
+            }
+
+            function(begin, count);
+        }
+        catch (...)
+        {
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+            throw;
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (std::exception_ptr& error : errors)
+        {
+            if (error != nullptr)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+
+    // HashSet__ownsAlone() returns true if no other shared_ptr shares
+    // ownership of what the given one points to (or it's empty), in which
+    // case its owner may modify it in place.  use_count() is only a relaxed
+    // load, so on its own it says nothing about whether the other owners,
+    // which may have been on other threads, have finished reading; the
+    // acquire fence pairs with the release in their shared_ptrs' final
+    // decrements, so that everything they did happens before whatever the
+    // caller does next.
+    template <typename T>
+    bool HashSet__ownsAlone(const std::shared_ptr<T>& pointer) noexcept
+    {
+        if (pointer.use_count() > 1)
+        {
+            return false;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return true;
+    }
+
+
+    // A HashSet__IndirectIterator walks an array of pointers, yielding what
+    // they point to, so that a HashSet can be built from the elements of
+    // another without copying them anywhere first.
+    template <typename T>
+    class HashSet__IndirectIterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        explicit HashSet__IndirectIterator(const T* const* curr) noexcept
+            : curr{curr}
+        {
+        }
+
+        const T& operator*() const noexcept
+        {
+            return **curr;
+        }
+
+        const T* operator->() const noexcept
+        {
+            return *curr;
+        }
+
+        HashSet__IndirectIterator& operator++() noexcept
+        {
+            ++curr;
+            return *this;
+        }
+
+        HashSet__IndirectIterator operator++(int) noexcept
+        {
+            HashSet__IndirectIterator old{*this};
+            ++curr;
+            return old;
+        }
+
+        bool operator==(const HashSet__IndirectIterator& other) const noexcept
+        {
+            return curr == other.curr;
+        }
+
+        bool operator!=(const HashSet__IndirectIterator& other) const noexcept
+        {
+            return curr != other.curr;
+        }
+
+    private:
+        const T* const* curr;
+    };
+
+
+    // HashSet__prefetch() asks the processor to start loading the cache
+    // line at the given address, without waiting for it to arrive.
+    inline void HashSet__prefetch(const void* address) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+#else
+        static_cast<void>(address);
+#endif
+    }
+}
+
+
+
+// A HashSet's hasher is a function object that takes a reference to a
+// const ElementType and returns an unsigned int.  Since its type is a
+// template parameter of the HashSet, a stateless hasher like DefaultHasher
+// (see Hashing.hpp) is called directly and can be inlined into every add()
+// and contains().
+
+
+
+// HashSetFunctionHasher is the hasher a HashSet uses unless it's told
+// otherwise.  It adapts any function (a function pointer, a lambda, a
+// std::function, and so on) that can hash an ElementType, storing it in a
+// std::function, so that a HashSet can be initialized with a hash function
+// without naming its type.  The cost is that every hash is an indirect
+// call that can't be inlined.
+//
+// If it's given a transparent hash function (one whose type declares
+// is_transparent), it can also hash KeyViews.
+
+template <typename ElementType>
+class HashSetFunctionHasher
+{
+public:
+    using HashFunction = std::function<unsigned int(const ElementType&)>;
+    using KeyView = typename HashSetKeyView<ElementType>::type;
+    using KeyHashFunction = std::function<unsigned int(KeyView)>;
+
+public:
+    template <typename Function,
+              typename = std::enable_if_t<
+                  !impl_::HashSet__isTransparent<Function>::value
+                  && !std::is_same<Function, HashSetFunctionHasher>::value
+                  && std::is_invocable_r<unsigned int, Function, const ElementType&>::value>>
+    HashSetFunctionHasher(Function function);
+
+    template <typename TransparentHash,
+              typename = typename TransparentHash::is_transparent,
+              typename = void>
+    HashSetFunctionHasher(TransparentHash hash);
+
+    unsigned int operator()(const ElementType& element) const;
+
+    // hashesKeys() returns true if this hasher can hash a KeyView, in
+    // which case hashKey() hashes one.
+    bool hashesKeys() const noexcept;
+    unsigned int hashKey(KeyView key) const;
+
+private:
+    HashFunction function;
+    KeyHashFunction keyFunction;
+};
+
+
+
+template <typename ElementType>
+template <typename Function, typename>
+HashSetFunctionHasher<ElementType>::HashSetFunctionHasher(Function function)
+    : function{function}
+{
+}
+
+
 template <typename ElementType>
+template <typename TransparentHash, typename, typename>
+HashSetFunctionHasher<ElementType>::HashSetFunctionHasher(TransparentHash hash)
+    : function{[hash](const ElementType& element) { return hash(KeyView{element}); }},
+      keyFunction{hash}
+{
+}
+
+
+template <typename ElementType>
+unsigned int HashSetFunctionHasher<ElementType>::operator()(const ElementType& element) const
+{
+    return function(element);
+}
+
+
+template <typename ElementType>
+bool HashSetFunctionHasher<ElementType>::hashesKeys() const noexcept
+{
+    return static_cast<bool>(keyFunction);
+}
+
+
+template <typename ElementType>
+unsigned int HashSetFunctionHasher<ElementType>::hashKey(KeyView key) const
+{
+    return keyFunction(key);
+}
+
+
+
+template <typename ElementType, typename Hasher = HashSetFunctionHasher<ElementType>>
 class HashSet : public Set<ElementType>
 {
 public:
@@ -17,19 +497,90 @@ public:
     // added to it.
     static constexpr unsigned int DEFAULT_CAPACITY = 10;
 
+    // The number of buckets moved from the old array to the new one by
+    // each call to add() or remove() while an incremental resize is in
+    // progress.  Since the new array is twice the size of the old one and
+    // a resize happens when the load factor would exceed 0.8, anything
+    // above 1.25 guarantees that one resize is finished before the next
+    // one is needed.
+    static constexpr unsigned int BUCKETS_MOVED_PER_ADD = 4;
+
+    // The number of elements that containsBatch() has in flight at once.
+    static constexpr unsigned int BATCH_WIDTH = 16;
+
+    // The fewest elements that the range constructor gives each thread to
+    // hash; smaller ranges are hashed on fewer threads (or just one), since
+    // starting a thread costs more than hashing a few thousand elements.
+    static constexpr unsigned int MIN_ELEMENTS_PER_THREAD = 16384;
+
     // A HashFunction is a function that takes a reference to a const
     // ElementType and returns an unsigned int.
     using HashFunction = std::function<unsigned int(const ElementType&)>;
 
+    // A KeyView is a lightweight view of an element (see HashSetKeyView,
+    // above).
+    using KeyView = typename HashSetKeyView<ElementType>::type;
+
+    // An Iterator is a forward iterator over the elements (see begin() and
+    // end(), below).
+    class Iterator;
+
 public:
     // Initializes a HashSet to be empty, so that it will use the given
-    // hash function whenever it needs to hash an element.
-    explicit HashSet(HashFunction hashFunction);
-
-    // Cleans up the HashSet so that it leaks no memory.
+    // hasher whenever it needs to hash an element.  Unless the HashSet's
+    // Hasher type says otherwise, the hasher can be any function that
+    // hashes an ElementType (see HashSetFunctionHasher, above).  If
+    // resizeIncrementally is true, growing the array doesn't rehash every
+    // element at once; instead, the old and new arrays are kept side by
+    // side and each subsequent add() moves a few buckets across, so that
+    // no single add() rehashes a number of elements proportional to the
+    // size of the set.  The add() that starts a resize still allocates the
+    // new array, which is zero-filled; a large one is taken from the
+    // operating system as fresh pages, which are cleared as they're first
+    // touched, but where the allocator recycles memory instead, clearing
+    // it takes time proportional to the size of the array (though far less
+    // than rehashing would).
+    //
+    // Nodes are carved out of large slabs taken from the given memory
+    // resource (see NodePool.hpp), rather than being allocated one at a
+    // time, so the HashSet can be placed in an arena by passing, say, a
+    // std::pmr::monotonic_buffer_resource.
+    //
+    // If the hasher is "transparent" (i.e., its type declares a member
+    // type named is_transparent, as in the standard library), it must be
+    // able to hash a KeyView, and the HashSet can then be searched for a
+    // KeyView without ever constructing an ElementType.
+    explicit HashSet(
+        Hasher hasher = Hasher(), bool resizeIncrementally = false,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Initializes a HashSet containing the elements in the range from first
+    // up to (but not including) last, each only once, even if it appears
+    // more than once.  The other parameters are as above.  The array is
+    // sized for the whole range before anything is added, so it's never
+    // resized along the way; the elements are then hashed in parallel, on
+    // up to one thread per hardware thread, and finally linked into their
+    // buckets in a single pass.  Since the hasher is called from several
+    // threads at once, it must be safe to call concurrently (as any
+    // stateless hasher is).
+    template <typename ForwardIterator,
+              typename = typename std::iterator_traits<ForwardIterator>::iterator_category>
+    HashSet(
+        ForwardIterator first, ForwardIterator last,
+        Hasher hasher = Hasher(), bool resizeIncrementally = false,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Cleans up the HashSet so that it leaks no memory.  The nodes' memory
+    // is returned a slab at a time; when ElementType has a trivial
+    // destructor, the nodes aren't visited at all.
     virtual ~HashSet() noexcept;
 
-    // Initializes a new HashSet to be a copy of an existing one.
+    // Initializes a new HashSet to be a copy of an existing one.  Copying
+    // is copy-on-write: the copy shares the original's nodes and arrays,
+    // so it runs in constant time, and whichever of them is next modified
+    // (by add(), remove(), or reserve()) first makes a copy of its own, in
+    // linear time.  Until then, a copy can be searched on one thread while
+    // the original is modified on another.
     HashSet(const HashSet& s);
 
     // Initializes a new HashSet whose contents are moved from an
@@ -43,387 +594,1430 @@ public:
     HashSet& operator=(HashSet&& s) noexcept;
 
 
-    // isImplemented() should be modified to return true if you've
-    // decided to implement a HashSet, false otherwise.
-    virtual bool isImplemented() const noexcept override;
+    // isImplemented() should be modified to return true if you've
+    // decided to implement a HashSet, false otherwise.
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the set,
+    // this function has no effect.  This function triggers a resizing of the
+    // array when the ratio of size to capacity would exceed 0.8.  In the case
+    // where the array is resized all at once, this function runs in linear
+    // time (with respect to the number of elements, assuming a good hash
+    // function); otherwise, including every call when the HashSet resizes
+    // incrementally, it runs in constant time (again, assuming a good hash
+    // function).
+    virtual void add(const ElementType& element) override;
+
+
+    // remove() removes an element from the set.  If the element isn't in
+    // the set, this function has no effect.  The element's node is
+    // unlinked from its chain, so nothing is left behind to slow down
+    // later searches.  When the ratio of size to capacity falls below 0.2,
+    // the array is halved (down to DEFAULT_CAPACITY), and unless the set
+    // resizes incrementally, its nodes are copied into a fresh pool so
+    // that the memory left over from a mass deletion is returned; in that
+    // case, this function runs in linear time, otherwise in constant time
+    // (assuming a good hash function).  A Bloom filter, if there is one,
+    // is left as it is, since it can't forget anything; it just lets a
+    // few more searches through until it's next rebuilt.
+    void remove(const ElementType& element);
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in constant time (with respect
+    // to the number of elements, assuming a good hash function).  While an
+    // incremental resize is in progress, it looks in both arrays, but never
+    // moves anything itself.
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // This version of contains() accepts anything that can be converted to
+    // a KeyView, such as a std::string_view or a const char* when the
+    // elements are std::strings.  If the HashSet's hasher is transparent,
+    // no ElementType is constructed to do the search; otherwise, the key
+    // is converted to an ElementType first.
+    template <typename KeyType,
+              typename = std::enable_if_t<
+                  std::is_convertible<const KeyType&, KeyView>::value
+                  && !std::is_same<KeyType, ElementType>::value>>
+    bool contains(const KeyType& key) const;
+
+
+    // containsBatch() stores, in results[i], whether elements[i] is in the
+    // set, for each i from 0 to count - 1.  The answers are the same as
+    // calling contains() on each element, but the lookups are overlapped:
+    // BATCH_WIDTH elements at a time are hashed and their buckets
+    // prefetched, then the first node of each bucket is prefetched, and
+    // only then are the chains searched.  When the set is too large to
+    // fit in the cache, this lets the processor wait for many cache misses
+    // at once instead of one after another.
+    void containsBatch(const ElementType* elements, unsigned int count, bool* results) const;
+
+
+    // setUnion(), setIntersection(), and setDifference() return a new
+    // HashSet containing the elements that are in this set or the given
+    // one, in both, or in this one but not the given one, respectively.
+    // The result uses this set's hasher, resizing policy, and memory
+    // resource.  Rather than calling contains() element by element, they
+    // walk the candidate set's buckets in place, split into slices that are
+    // searched on several threads when there are enough of them (see
+    // MIN_ELEMENTS_PER_THREAD), looking the elements of each slice up in
+    // batches as containsBatch() does; only the elements that end up in the
+    // result are copied, once, by the range constructor.  setIntersection()
+    // searches the larger set for the elements of the smaller one.  They run in linear time (with
+    // respect to the sizes of the two sets, assuming good hash functions).
+    HashSet setUnion(const HashSet& s) const;
+    HashSet setIntersection(const HashSet& s) const;
+    HashSet setDifference(const HashSet& s) const;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // reserve() makes the array large enough to hold the given number of
+    // elements without exceeding a load factor of 0.8, so that adding that
+    // many elements never triggers a resizing.  If the array is already
+    // large enough, this function has no effect; otherwise, every element
+    // is rehashed immediately, even when the HashSet resizes incrementally,
+    // so it runs in linear time.
+    void reserve(unsigned int count);
+
+
+    // enableBloomFilter() puts a blocked Bloom filter (see BloomFilter.hpp)
+    // in front of the table, using the given number of bits per element,
+    // so that most searches for elements that aren't in the set return
+    // false without touching the table.  The filter is kept up to date by
+    // add(), and is rebuilt, twice as large, whenever the set outgrows
+    // what it was sized for; that takes time proportional to the size of
+    // the set, even when resizing incrementally.  Enabling it again
+    // rebuilds it with the new number of bits and resets its stats.
+    void enableBloomFilter(unsigned int bitsPerKey = BloomFilter::DEFAULT_BITS_PER_KEY);
+
+
+    // disableBloomFilter() removes the Bloom filter, if there is one.
+    void disableBloomFilter() noexcept;
+
+
+    // bloomFilterStats() returns the number of calls to contains() that
+    // the Bloom filter answered by itself (its rejections), and the number
+    // it let through that still returned false (its false positives).  If
+    // there's no Bloom filter, both are 0.  Each copy of a HashSet counts
+    // its own searches, even while the copies share one filter.
+    BloomFilterStats bloomFilterStats() const noexcept;
+
+
+    // elements() returns a vector containing a copy of every element in
+    // the set, in no particular order.
+    std::vector<ElementType> elements() const;
+
+
+    // begin() and end() return Iterators that visit every element of the
+    // set once, walking the array's buckets in memory order (followed by
+    // any that haven't yet been moved out of the old array, during an
+    // incremental resize), and each bucket's chain from front to back.
+    // Iterating allocates nothing.  The elements can't be modified through
+    // an Iterator, and adding or removing elements invalidates every
+    // Iterator.
+    Iterator begin() const noexcept;
+    Iterator end() const noexcept;
+
+
+    // forEach() calls visit(element) for each element of the set, in the
+    // same order as the Iterators.  Since the type of the visitor is a
+    // template parameter, rather than a std::function, the call can be
+    // inlined.  The visitor must not add or remove elements.
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const;
+
+
+    // parallelForEach() is like forEach(), but splits the buckets into
+    // slices that are visited on several threads at once (when there are
+    // enough of them; see MIN_ELEMENTS_PER_THREAD), so the visitor must be
+    // safe to call concurrently, and the order of the calls is
+    // unpredictable.  If the visitor throws, the exception is rethrown
+    // once every thread has finished.
+    template <typename Visitor>
+    void parallelForEach(Visitor&& visit) const;
+
+
+    // stats() returns a snapshot of the set's shape (see HashSetStats,
+    // above): its load factor, how long its chains are, how many of its
+    // buckets are empty, how often it has been resized, and how much work
+    // contains() has done.  The counters are read without stopping other
+    // threads, but the chain lengths are found by walking every bucket, so
+    // this function runs in linear time and, like add(), must not run at
+    // the same time as anything that modifies the set.
+    HashSetStats stats() const;
+
+
+    // bucketCount() returns the number of buckets in the array (i.e., the
+    // number of indexes that elementsAtIndex() accepts).
+    unsigned int bucketCount() const noexcept;
+
+
+    // elementsAtIndex() returns the number of elements that hashed to a
+    // particular index in the array (including any that hashed there but
+    // haven't yet been moved out of the old array during an incremental
+    // resize).  If the index is out of the boundaries of the array, this
+    // function returns 0.
+    unsigned int elementsAtIndex(unsigned int index) const;
+
+
+    // isElementAtIndex() returns true if the given element hashed to a
+    // particular index in the array, false otherwise.  If the index is
+    // out of the boundaries of the array, this functions returns 0.
+    bool isElementAtIndex(const ElementType& element, unsigned int index) const;
+
+
+private:
+    Hasher hasher;
+
+    static constexpr bool CACHES_HASH = HashSetCachesHash<ElementType>::value;
+
+    struct Node
+    {
+        ElementType element;
+
+        // The hash is only meaningful if CACHES_HASH is true; otherwise,
+        // it's a placeholder that fits into the padding after element.
+        std::conditional_t<CACHES_HASH, unsigned int, bool> hash;
+        Node* next;
+
+        Node(ElementType newElement, unsigned int newHash, Node* newNext = nullptr);
+    };
+
+    // A Storage holds the nodes and the arrays that link them.  Copies of
+    // a HashSet share one Storage until one of them is modified, at which
+    // point that one makes a Storage of its own (see detach()).  While an
+    // incremental resize is in progress, oldTable is the array being
+    // emptied and every bucket before movedBuckets has already been
+    // emptied; otherwise, oldTable is nullptr.
+    struct Storage
+    {
+        NodePool<Node> pool;
+        Node** table;
+        unsigned int capacity;
+        Node** oldTable;
+        unsigned int oldCapacity;
+        unsigned int movedBuckets;
+
+        Storage(std::pmr::memory_resource* resource, unsigned int capacity);
+        Storage(const Storage& s);
+        ~Storage() noexcept;
+        Storage& operator=(const Storage& s) = delete;
+    };
+
+    std::shared_ptr<Storage> storage;
+    unsigned int sz;
+    bool incremental;
+
+    // The counters reported by stats().  When HASHSET_COUNT_PROBES is 0,
+    // they're empty, and declaring them here lets them sit in the padding
+    // after incremental.
+    mutable impl_::HashSet__Counters<HASHSET_COUNT_PROBES != 0> counters;
+
+    // The Bloom filter, if enableBloomFilter() has been called; otherwise,
+    // nullptr.  Like the Storage, it's shared between copies until one of
+    // them adds an element.
+    std::shared_ptr<BloomFilter> filter;
+
+    // The counters reported by bloomFilterStats().
+    mutable impl_::HashSet__FilterCounters filterCounters;
+
+    std::uint64_t resizes;
+
+
+private:
+    void printAll(Node** table);
+    static void destroyAll(Node** table, unsigned int capacity);
+    static Node** copyAll(NodePool<Node>& pool, Node** table, int capacity);
+    static Node** emptyTable(unsigned int capacity);
+    void detach();
+    void resize(unsigned int newCapacity);
+    void moveBuckets(unsigned int count);
+    bool unlink(Node*& head, const ElementType& element, unsigned int hash);
+    template <typename KeyType>
+    bool containsHashed(const KeyType& key, unsigned int hash) const;
+    template <typename KeyType>
+    bool tableContains(const KeyType& key, unsigned int hash, unsigned int& probes) const;
+    void rebuildBloomFilter(unsigned int expectedKeys, unsigned int bitsPerKey);
+    template <typename KeyType>
+    bool chainContains(Node* curr, const KeyType& key, unsigned int hash, unsigned int& probes) const;
+    void countLookups(unsigned int lookups, unsigned int probes) const noexcept;
+    unsigned int hashOf(const Node* node) const;
+    template <typename ForwardIterator>
+    std::vector<unsigned int> hashAll(ForwardIterator first, unsigned int count) const;
+    template <typename Visitor>
+    void visitBuckets(unsigned int first, unsigned int last, Visitor& visit) const;
+    template <typename ElementAt>
+    void searchBatch(ElementAt elementAt, unsigned int count, bool* results) const;
+    std::vector<const ElementType*> select(const HashSet& candidates, bool present) const;
+
+};
+
+
+
+template <typename ElementType, typename Hasher>
+class HashSet<ElementType, Hasher>::Iterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ElementType;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const ElementType*;
+    using reference = const ElementType&;
+
+public:
+    // A default-constructed Iterator can only be assigned to.
+    Iterator() noexcept;
+
+    reference operator*() const noexcept;
+    pointer operator->() const noexcept;
+    Iterator& operator++() noexcept;
+    Iterator operator++(int) noexcept;
+
+    bool operator==(const Iterator& other) const noexcept;
+    bool operator!=(const Iterator& other) const noexcept;
+
+private:
+    friend class HashSet;
+
+    // bucket counts through the buckets of the current array, then on
+    // through those of the old array; node is nullptr only at the end.
+    const HashSet* set;
+    unsigned int bucket;
+    Node* node;
+
+    Iterator(const HashSet* set, unsigned int bucket) noexcept;
+    Node* head(unsigned int index) const noexcept;
+    void skipEmptyBuckets() noexcept;
+};
+
+
+
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>::Node::Node(ElementType newElement, unsigned int newHash, Node* newNext)
+    : element(newElement), hash(newHash), next(newNext)
+{
+}
+
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>::Storage::Storage(
+    std::pmr::memory_resource* resource, unsigned int capacity)
+    : pool{resource}, table{emptyTable(capacity)}, capacity{capacity},
+      oldTable{nullptr}, oldCapacity{0}, movedBuckets{0}
+{
+}
+
+
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>::Storage::Storage(const Storage& s)
+    : pool{s.pool.resource()}, table{nullptr}, capacity{s.capacity},
+      oldTable{nullptr}, oldCapacity{0}, movedBuckets{0}
+{
+    table = copyAll(pool, s.table, s.capacity);
+
+    if (s.oldTable != nullptr)
+    {
+        try
+        {
+            oldTable = copyAll(pool, s.oldTable, s.oldCapacity);
+        }
+        catch (...)
+        {
+            destroyAll(table, capacity);
+            throw;
+        }
+
+        oldCapacity = s.oldCapacity;
+        movedBuckets = s.movedBuckets;
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>::Storage::~Storage() noexcept
+{
+    destroyAll(table, capacity);
+
+    if (oldTable != nullptr)
+    {
+        destroyAll(oldTable, oldCapacity);
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>::HashSet(
+    Hasher hasher, bool resizeIncrementally,
+    std::pmr::memory_resource* resource)
+    : hasher{hasher}, storage{std::make_shared<Storage>(resource, DEFAULT_CAPACITY)},
+      sz{0}, incremental{resizeIncrementally}, resizes{0}
+{
+}
+
+
+template <typename ElementType, typename Hasher>
+template <typename ForwardIterator, typename>
+HashSet<ElementType, Hasher>::HashSet(
+    ForwardIterator first, ForwardIterator last,
+    Hasher hasher, bool resizeIncrementally,
+    std::pmr::memory_resource* resource)
+    : HashSet(hasher, resizeIncrementally, resource)
+{
+    unsigned int count = std::distance(first, last);
+    reserve(count);
+
+    std::vector<unsigned int> hashes = hashAll(first, count);
+    unsigned int probes = 0;
+
+    for (unsigned int i = 0; i < count; ++i, ++first)
+    {
+        Node*& head = storage->table[hashes[i] % storage->capacity];
+
+        if (!chainContains(head, *first, hashes[i], probes))
+        {
+            head = storage->pool.create(*first, hashes[i], head);
+            ++sz;
+        }
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>::~HashSet() noexcept
+{
+}
+
+
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>::HashSet(const HashSet& s)
+    : hasher{s.hasher}, storage{s.storage}, sz{s.sz}, incremental{s.incremental},
+      counters{s.counters}, filter{s.filter}, filterCounters{s.filterCounters},
+      resizes{s.resizes}
+{
+}
+
+
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>::HashSet(HashSet&& s) noexcept
+    : hasher{s.hasher},
+      storage{std::make_shared<Storage>(s.storage->pool.resource(), DEFAULT_CAPACITY)},
+      sz{0}, incremental{s.incremental}, counters{s.counters},
+      filterCounters{s.filterCounters}, resizes{s.resizes}
+{
+    std::swap(storage, s.storage);
+    std::swap(sz, s.sz);
+    std::swap(filter, s.filter);
+}
+
+
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>& HashSet<ElementType, Hasher>::operator=(const HashSet& s)
+{
+    if (this != &s)
+    {
+        HashSet copy{s};
+        std::swap(hasher, copy.hasher);
+        std::swap(storage, copy.storage);
+        std::swap(sz, copy.sz);
+        std::swap(incremental, copy.incremental);
+        std::swap(counters, copy.counters);
+        std::swap(filter, copy.filter);
+        std::swap(filterCounters, copy.filterCounters);
+        std::swap(resizes, copy.resizes);
+    }
+    return *this;
+}
+
+
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>& HashSet<ElementType, Hasher>::operator=(HashSet&& s) noexcept
+{
+    std::swap(hasher, s.hasher);
+    std::swap(storage, s.storage);
+    std::swap(sz, s.sz);
+    std::swap(incremental, s.incremental);
+    std::swap(counters, s.counters);
+    std::swap(filter, s.filter);
+    std::swap(filterCounters, s.filterCounters);
+    std::swap(resizes, s.resizes);
+    return *this;
+}
+
+
+template <typename ElementType, typename Hasher>
+bool HashSet<ElementType, Hasher>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::add(const ElementType& element)
+{
+    //std::cout << "ADD" << std::endl;
+
+    unsigned int hash = hasher(element);
+
+    // The search here goes around containsHashed(), so that it isn't
+    // counted in the Bloom filter's stats.
+    unsigned int probes = 0;
+
+    if ((filter == nullptr || filter->mayContain(hash)) && tableContains(element, hash, probes))
+    {
+        return;
+    }
+
+    detach();
+
+    if (storage->oldTable != nullptr)
+    {
+        moveBuckets(BUCKETS_MOVED_PER_ADD);
+    }
+
+    if (sz + 1 > storage->capacity * 0.8)
+    {
+        resize(storage->capacity * 2);
+    }
+
+    unsigned int i = hash % storage->capacity;
+    storage->table[i] = storage->pool.create(element, hash, storage->table[i]);
+    ++sz;
+
+    if (filter != nullptr)
+    {
+        if (sz > filter->expectedKeys())
+        {
+            rebuildBloomFilter(sz * 2, filter->bitsPerKey());
+        }
+        else
+        {
+            filter->insert(hash);
+        }
+    }
+    //printAll(table);
+}
+
+
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::remove(const ElementType& element)
+{
+    unsigned int hash = hasher(element);
+
+    // A set that shares its storage with a copy only gets a storage of its
+    // own if there's something to remove.
+    if (!impl_::HashSet__ownsAlone(storage))
+    {
+        unsigned int probes = 0;
+
+        if (!tableContains(element, hash, probes))
+        {
+            return;
+        }
+
+        detach();
+    }
+
+    if (storage->oldTable != nullptr)
+    {
+        moveBuckets(BUCKETS_MOVED_PER_ADD);
+    }
+
+    if (!unlink(storage->table[hash % storage->capacity], element, hash)
+        && !(storage->oldTable != nullptr && unlink(storage->oldTable[hash % storage->oldCapacity], element, hash)))
+    {
+        return;
+    }
+
+    --sz;
+
+    if (sz < storage->capacity * 0.2 && storage->capacity > DEFAULT_CAPACITY)
+    {
+        resize(std::max(storage->capacity / 2, DEFAULT_CAPACITY));
+
+        if (!incremental)
+        {
+            // Copying the storage gives the copy a pool containing only the
+            // remaining nodes; the old pool, and all of its slabs, are
+            // released when the copy replaces it.
+            storage = std::make_shared<Storage>(*storage);
+        }
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+bool HashSet<ElementType, Hasher>::contains(const ElementType& element) const
+{
+    return containsHashed(element, hasher(element));
+}
+
+
+template <typename ElementType, typename Hasher>
+template <typename KeyType, typename>
+bool HashSet<ElementType, Hasher>::contains(const KeyType& key) const
+{
+    KeyView view = key;
+
+    if constexpr (impl_::HashSet__isTransparent<Hasher>::value)
+    {
+        return containsHashed(view, hasher(view));
+    }
+    else if constexpr (std::is_same<Hasher, HashSetFunctionHasher<ElementType>>::value)
+    {
+        if (hasher.hashesKeys())
+        {
+            return containsHashed(view, hasher.hashKey(view));
+        }
+    }
+
+    return contains(ElementType(key));
+}
+
+
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::containsBatch(
+    const ElementType* elements, unsigned int count, bool* results) const
+{
+    searchBatch(
+        [elements](unsigned int i) -> const ElementType& { return elements[i]; },
+        count, results);
+}
+
+
+// searchBatch() is containsBatch(), for elements that aren't necessarily
+// contiguous: elementAt(i) returns the i-th of them.
+template <typename ElementType, typename Hasher>
+template <typename ElementAt>
+void HashSet<ElementType, Hasher>::searchBatch(
+    ElementAt elementAt, unsigned int count, bool* results) const
+{
+    unsigned int hashes[BATCH_WIDTH];
+    Node* heads[BATCH_WIDTH];
+    unsigned int probes = 0;
+
+    for (unsigned int start = 0; start < count; start += BATCH_WIDTH)
+    {
+        unsigned int width = std::min(BATCH_WIDTH, count - start);
+
+        for (unsigned int i = 0; i < width; ++i)
+        {
+            hashes[i] = hasher(elementAt(start + i));
+            impl_::HashSet__prefetch(&storage->table[hashes[i] % storage->capacity]);
+        }
+
+        for (unsigned int i = 0; i < width; ++i)
+        {
+            heads[i] = storage->table[hashes[i] % storage->capacity];
+            impl_::HashSet__prefetch(heads[i]);
+        }
+
+        for (unsigned int i = 0; i < width; ++i)
+        {
+            if (filter != nullptr && !filter->mayContain(hashes[i]))
+            {
+                filterCounters.countRejection();
+                results[start + i] = false;
+                continue;
+            }
+
+            results[start + i] = chainContains(heads[i], elementAt(start + i), hashes[i], probes)
+                || (storage->oldTable != nullptr
+                    && chainContains(
+                        storage->oldTable[hashes[i] % storage->oldCapacity],
+                        elementAt(start + i), hashes[i], probes));
+
+            if (filter != nullptr && !results[start + i])
+            {
+                filterCounters.countFalsePositive();
+            }
+        }
+    }
+
+    countLookups(count, probes);
+}
+
+
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher> HashSet<ElementType, Hasher>::setUnion(const HashSet& s) const
+{
+    std::vector<const ElementType*> missing = select(s, false);
+
+    HashSet result{*this};
+    result.reserve(sz + missing.size());
+
+    for (const ElementType* element : missing)
+    {
+        result.add(*element);
+    }
+
+    return result;
+}
+
+
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher> HashSet<ElementType, Hasher>::setIntersection(const HashSet& s) const
+{
+    std::vector<const ElementType*> common = s.sz < sz
+        ? select(s, true)
+        : s.select(*this, true);
+
+    using Indirect = impl_::HashSet__IndirectIterator<ElementType>;
+
+    return HashSet{
+        Indirect{common.data()}, Indirect{common.data() + common.size()},
+        hasher, incremental, storage->pool.resource()};
+}
+
+
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher> HashSet<ElementType, Hasher>::setDifference(const HashSet& s) const
+{
+    std::vector<const ElementType*> kept = s.select(*this, false);
+
+    using Indirect = impl_::HashSet__IndirectIterator<ElementType>;
+
+    return HashSet{
+        Indirect{kept.data()}, Indirect{kept.data() + kept.size()},
+        hasher, incremental, storage->pool.resource()};
+}
+
+
+template <typename ElementType, typename Hasher>
+unsigned int HashSet<ElementType, Hasher>::size() const noexcept
+{
+    //std::cout << "size: " << sz << std::endl;
+    return sz;
+}
+
+
+template <typename ElementType, typename Hasher>
+HashSetStats HashSet<ElementType, Hasher>::stats() const
+{
+    // Elements still in the old array of an incremental resize are counted
+    // in the bucket they'll be moved to.
+    std::vector<unsigned int> lengths(storage->capacity);
+
+    for (unsigned int i = 0; i < storage->capacity; ++i)
+    {
+        for (Node* curr = storage->table[i]; curr != nullptr; curr = curr->next)
+        {
+            ++lengths[i];
+        }
+    }
+
+    if (storage->oldTable != nullptr)
+    {
+        for (unsigned int i = storage->movedBuckets; i < storage->oldCapacity; ++i)
+        {
+            for (Node* curr = storage->oldTable[i]; curr != nullptr; curr = curr->next)
+            {
+                ++lengths[hashOf(curr) % storage->capacity];
+            }
+        }
+    }
+
+    unsigned int maxLength = *std::max_element(lengths.begin(), lengths.end());
+    std::vector<unsigned int> histogram(maxLength + 1);
+
+    for (unsigned int length : lengths)
+    {
+        ++histogram[length];
+    }
+
+    unsigned int nonEmpty = storage->capacity - histogram[0];
+    unsigned int p99Length = 0;
+
+    // The 99th percentile is the shortest length that at least 99% of the
+    // non-empty buckets are no longer than.
+    for (unsigned int length = 1, seen = 0; length <= maxLength; ++length)
+    {
+        seen += histogram[length];
+        if (seen * 100.0 >= nonEmpty * 99.0)
+        {
+            p99Length = length;
+            break;
+        }
+    }
+
+    HashSetStats result;
+    result.size = sz;
+    result.bucketCount = storage->capacity;
+    result.loadFactor = static_cast<double>(sz) / storage->capacity;
+    result.emptyBucketRatio = static_cast<double>(histogram[0]) / storage->capacity;
+    result.meanChainLength = nonEmpty == 0 ? 0.0 : static_cast<double>(sz) / nonEmpty;
+    result.p99ChainLength = p99Length;
+    result.maxChainLength = maxLength;
+    result.bucketsToMove = storage->oldTable != nullptr
+        ? storage->oldCapacity - storage->movedBuckets
+        : 0;
+    result.resizes = resizes;
+    result.lookups = counters.lookupCount();
+    result.probes = counters.probeCount();
+    return result;
+}
+
+
+template <typename ElementType, typename Hasher>
+unsigned int HashSet<ElementType, Hasher>::bucketCount() const noexcept
+{
+    return storage->capacity;
+}
+
+
+template <typename ElementType, typename Hasher>
+unsigned int HashSet<ElementType, Hasher>::elementsAtIndex(unsigned int index) const
+{
+    if (index < 0 || index >= storage->capacity)
+    {
+        return 0;
+    }
+    else
+    {
+        int length = 0;
+        Node* curr = storage->table[index];
+        while (curr != nullptr)
+        {
+            ++length;
+            curr = curr->next;
+        }
+
+        if (storage->oldTable != nullptr)
+        {
+            // After growing, everything that hashes to index comes from one
+            // old bucket; after shrinking, from every old bucket j with
+            // j % capacity == index; and when neither capacity divides the
+            // other, from any of them.  (Buckets already moved are empty.)
+            unsigned int first = 0;
+            unsigned int step = 1;
+
+            if (storage->capacity % storage->oldCapacity == 0)
+            {
+                first = index % storage->oldCapacity;
+                step = storage->oldCapacity;
+            }
+            else if (storage->oldCapacity % storage->capacity == 0)
+            {
+                first = index;
+                step = storage->capacity;
+            }
+
+            for (unsigned int j = first; j < storage->oldCapacity; j += step)
+            {
+                for (curr = storage->oldTable[j]; curr != nullptr; curr = curr->next)
+                {
+                    if (hashOf(curr) % storage->capacity == index)
+                    {
+                        ++length;
+                    }
+                }
+            }
+        }
+        return length;
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::reserve(unsigned int count)
+{
+    // The smallest capacity whose load factor stays at or below 0.8 with
+    // count elements: count * 1.25, rounded up, computed exactly.
+    unsigned int needed = static_cast<unsigned int>(
+        (static_cast<unsigned long long>(count) * 5 + 3) / 4);
+
+    if (needed <= storage->capacity)
+    {
+        return;
+    }
+
+    detach();
+
+    resize(needed);
+
+    if (storage->oldTable != nullptr)
+    {
+        moveBuckets(storage->oldCapacity);
+    }
+
+    if (filter != nullptr && count > filter->expectedKeys())
+    {
+        rebuildBloomFilter(count, filter->bitsPerKey());
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::enableBloomFilter(unsigned int bitsPerKey)
+{
+    filter.reset();
+    filterCounters = impl_::HashSet__FilterCounters{};
+    rebuildBloomFilter(std::max(sz * 2, storage->capacity), bitsPerKey);
+}
+
+
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::disableBloomFilter() noexcept
+{
+    filter.reset();
+}
+
+
+template <typename ElementType, typename Hasher>
+BloomFilterStats HashSet<ElementType, Hasher>::bloomFilterStats() const noexcept
+{
+    if (filter == nullptr)
+    {
+        return BloomFilterStats{0, 0};
+    }
+
+    return filterCounters.stats();
+}
+
+
+template <typename ElementType, typename Hasher>
+std::vector<ElementType> HashSet<ElementType, Hasher>::elements() const
+{
+    std::vector<ElementType> result;
+    result.reserve(sz);
+
+    forEach([&result](const ElementType& element) {
+        result.push_back(element);
+    });
+
+    return result;
+}
+
+
+template <typename ElementType, typename Hasher>
+typename HashSet<ElementType, Hasher>::Iterator HashSet<ElementType, Hasher>::begin() const noexcept
+{
+    return Iterator{this, 0};
+}
+
+
+template <typename ElementType, typename Hasher>
+typename HashSet<ElementType, Hasher>::Iterator HashSet<ElementType, Hasher>::end() const noexcept
+{
+    return Iterator{};
+}
+
+
+template <typename ElementType, typename Hasher>
+template <typename Visitor>
+void HashSet<ElementType, Hasher>::forEach(Visitor&& visit) const
+{
+    visitBuckets(0, storage->capacity + storage->oldCapacity, visit);
+}
+
+
+template <typename ElementType, typename Hasher>
+template <typename Visitor>
+void HashSet<ElementType, Hasher>::parallelForEach(Visitor&& visit) const
+{
+    impl_::HashSet__inParallel(
+        storage->capacity + storage->oldCapacity, MIN_ELEMENTS_PER_THREAD,
+        [this, &visit](unsigned int first, unsigned int last) {
+            visitBuckets(first, last, visit);
+        });
+}
 
 
-    // add() adds an element to the set.  If the element is already in the set,
-    // this function has no effect.  This function triggers a resizing of the
-    // array when the ratio of size to capacity would exceed 0.8.  In the case
-    // where the array is resized, this function runs in linear time (with
-    // respect to the number of elements, assuming a good hash function);
-    // otherwise, it runs in constant time (again, assuming a good hash
-    // function).
-    virtual void add(const ElementType& element) override;
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>::Iterator::Iterator() noexcept
+    : set{nullptr}, bucket{0}, node{nullptr}
+{
+}
 
 
-    // contains() returns true if the given element is already in the set,
-    // false otherwise.  This function runs in constant time (with respect
-    // to the number of elements, assuming a good hash function).
-    virtual bool contains(const ElementType& element) const override;
+template <typename ElementType, typename Hasher>
+HashSet<ElementType, Hasher>::Iterator::Iterator(const HashSet* set, unsigned int bucket) noexcept
+    : set{set}, bucket{bucket}, node{head(bucket)}
+{
+    skipEmptyBuckets();
+}
 
 
-    // size() returns the number of elements in the set.
-    virtual unsigned int size() const noexcept override;
+template <typename ElementType, typename Hasher>
+typename HashSet<ElementType, Hasher>::Iterator::reference
+HashSet<ElementType, Hasher>::Iterator::operator*() const noexcept
+{
+    return node->element;
+}
 
 
-    // elementsAtIndex() returns the number of elements that hashed to a
-    // particular index in the array.  If the index is out of the boundaries
-    // of the array, this function returns 0.
-    unsigned int elementsAtIndex(unsigned int index) const;
+template <typename ElementType, typename Hasher>
+typename HashSet<ElementType, Hasher>::Iterator::pointer
+HashSet<ElementType, Hasher>::Iterator::operator->() const noexcept
+{
+    return &node->element;
+}
 
 
-    // isElementAtIndex() returns true if the given element hashed to a
-    // particular index in the array, false otherwise.  If the index is
-    // out of the boundaries of the array, this functions returns 0.
-    bool isElementAtIndex(const ElementType& element, unsigned int index) const;
+template <typename ElementType, typename Hasher>
+typename HashSet<ElementType, Hasher>::Iterator&
+HashSet<ElementType, Hasher>::Iterator::operator++() noexcept
+{
+    node = node->next;
+    skipEmptyBuckets();
+    return *this;
+}
 
 
-private:
-    HashFunction hashFunction;
+template <typename ElementType, typename Hasher>
+typename HashSet<ElementType, Hasher>::Iterator
+HashSet<ElementType, Hasher>::Iterator::operator++(int) noexcept
+{
+    Iterator previous = *this;
+    ++*this;
+    return previous;
+}
 
-    struct Node
-    {
-        ElementType element;
-        Node* next;
 
-        Node(ElementType newElement, Node* newNext = nullptr);
-    };
+template <typename ElementType, typename Hasher>
+bool HashSet<ElementType, Hasher>::Iterator::operator==(const Iterator& other) const noexcept
+{
+    return node == other.node;
+}
 
-    Node** table;
-    unsigned int sz;
-    unsigned int capacity;
 
+template <typename ElementType, typename Hasher>
+bool HashSet<ElementType, Hasher>::Iterator::operator!=(const Iterator& other) const noexcept
+{
+    return node != other.node;
+}
 
-private:
-    void printAll(Node** table);
-    void destroyAll(Node** table);
-    Node** copyAll(Node** table, int capacity);
 
-};
+// head() returns the first node of the given bucket, counting the buckets
+// of the old array after those of the current one.  (Buckets of the old
+// array that have already been moved are empty.)
+template <typename ElementType, typename Hasher>
+typename HashSet<ElementType, Hasher>::Node*
+HashSet<ElementType, Hasher>::Iterator::head(unsigned int index) const noexcept
+{
+    if (index < set->storage->capacity)
+    {
+        return set->storage->table[index];
+    }
 
+    index -= set->storage->capacity;
+    return index < set->storage->oldCapacity ? set->storage->oldTable[index] : nullptr;
+}
 
 
-namespace impl_
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::Iterator::skipEmptyBuckets() noexcept
 {
-    template <typename ElementType>
-    unsigned int HashSet__undefinedHashFunction(const ElementType& element)
+    unsigned int bucketCount = set->storage->capacity + set->storage->oldCapacity;
+
+    while (node == nullptr && ++bucket < bucketCount)
     {
-        return 0;
+        node = head(bucket);
     }
 }
 
-template <typename ElementType>
-HashSet<ElementType>::Node::Node(ElementType newElement, Node* newNext)
-    : element(newElement), next(newNext)
+
+template <typename ElementType, typename Hasher>
+bool HashSet<ElementType, Hasher>::isElementAtIndex(const ElementType& element, unsigned int index) const
 {
+    if (index < 0 || index >= storage->capacity)
+    {
+        return 0;
+    }
+    else
+    {
+        unsigned int hash = hasher(element);
+        return hash % storage->capacity == index && containsHashed(element, hash);
+    }
 }
 
-template <typename ElementType>
-HashSet<ElementType>::HashSet(HashFunction hashFunction)
-    : hashFunction{hashFunction}
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::printAll(Node** table)
 {
-    //std::cout << "DEFAULT_CAPACITY" << std::endl;
-
-    capacity = DEFAULT_CAPACITY;
-    sz = 0;
-    table = new Node* [capacity];
-
-    for (int i = 0; i < capacity; ++i)
+    for (int i = 0; i < storage->capacity; ++i)
     {
-        table[i] = nullptr;
+        std::cout << i << ": ";
+        Node* temp = table[i];
+        while (temp != nullptr)
+        {
+            std::cout << temp->element << " -> ";
+            temp = temp->next;
+        }
+        std::cout << std::endl;
     }
-
-    //printAll(table);
+    std::cout << std::endl;
 }
 
-
-template <typename ElementType>
-HashSet<ElementType>::~HashSet() noexcept
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::destroyAll(Node** table, unsigned int capacity)
 {
-    destroyAll(table);
-    /*
-    Node* temp;
-    Node* curr;
-    for (int i = 0; i < capacity; ++i)
+    // The nodes' memory belongs to the pool, which gives it back a slab at
+    // a time, so all that's left to do here is run their destructors (if
+    // they do anything).
+    if (!std::is_trivially_destructible<ElementType>::value)
     {
-        if (table[i] != nullptr)
+        Node* temp;
+        Node* curr;
+        for (unsigned int i = 0; i < capacity; ++i)
         {
             curr = table[i];
+
             while (curr != nullptr)
             {
                 temp = curr;
-                delete temp;
                 curr = curr->next;
+                temp->~Node();
             }
+            table[i] = nullptr;
         }
-        table[i] = nullptr;
     }
-    delete[] table;
-    */
+    std::free(table);
 }
 
-
-template <typename ElementType>
-HashSet<ElementType>::HashSet(const HashSet& s)
-    : hashFunction{impl_::HashSet__undefinedHashFunction<ElementType>}
+template <typename ElementType, typename Hasher>
+typename HashSet<ElementType, Hasher>::Node** HashSet<ElementType, Hasher>::copyAll(
+    NodePool<Node>& pool, Node** table, int capacity)
 {
-    //std::cout << "COPY CONSTRUCTOR" << std::endl;
+    Node** newHash = emptyTable(capacity);
 
-    table = copyAll(s.table, s.capacity);
-    sz = s.sz;
-    capacity = s.capacity;
-    //printAll(table);  
-}
+    for (int i = 0; i < capacity; ++i)
+    {
+        //std::cout << "INDEX: " << i << std::endl;
+        Node* curr = table[i];
+        Node** newList = &newHash[i];
 
+        while (curr != nullptr)
+        {
+            *newList = pool.create(curr->element, curr->hash);
+            //std::cout << curr->element << std::endl;
+            newList = &(*newList)->next;
+            curr = curr->next;
+        }
+        *newList = nullptr;
+    }
+    return newHash;
+}
 
-template <typename ElementType>
-HashSet<ElementType>::HashSet(HashSet&& s) noexcept
-    : hashFunction{impl_::HashSet__undefinedHashFunction<ElementType>}
+template <typename ElementType, typename Hasher>
+typename HashSet<ElementType, Hasher>::Node** HashSet<ElementType, Hasher>::emptyTable(
+    unsigned int capacity)
 {
+    // The array comes from calloc() rather than new, so that a large one
+    // can be taken straight from the operating system as zero-filled pages,
+    // which are only cleared as they're first touched.  Otherwise, clearing
+    // the array would take time proportional to its size all at once, in
+    // the add() that starts a resize, even when resizing incrementally.
+    // (All of the platforms this code targets represent nullptr as zero.)
+    Node** newTable = static_cast<Node**>(std::calloc(capacity, sizeof(Node*)));
+
+    if (newTable == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+    return newTable;
+}
 
-    capacity = DEFAULT_CAPACITY;
-    sz = 0;
-    table = new Node* [capacity];
-
-    for (int i = 0; i < capacity; ++i)
+// detach() gives the set a Storage and Bloom filter of its own, copying the
+// ones it shares with its copies, if it shares them, so that it can modify
+// them without the copies seeing it.  The copies share the nodes of an
+// unmodified set, too, so the copying is deferred until it's needed.
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::detach()
+{
+    if (!impl_::HashSet__ownsAlone(storage))
     {
-        table[i] = nullptr;
+        storage = std::make_shared<Storage>(*storage);
     }
 
-    std::swap(table, s.table);
-    std::swap(capacity, s.capacity);
-    std::swap(sz, s.sz);
+    if (!impl_::HashSet__ownsAlone(filter))
+    {
+        filter = std::make_shared<BloomFilter>(*filter);
+    }
 }
 
-
-template <typename ElementType>
-HashSet<ElementType>& HashSet<ElementType>::operator=(const HashSet& s)
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::resize(unsigned int newCapacity)
 {
-    if (this != &s)
+    // A resize that's still in progress has to finish before another one
+    // can start.  (That can't happen as a result of adding elements, given
+    // BUCKETS_MOVED_PER_ADD, but it can when elements are also removed.)
+    if (storage->oldTable != nullptr)
     {
-        Node** temp = copyAll(s.table, s.capacity);
-        destroyAll(table);
-        table = temp;
+        moveBuckets(storage->oldCapacity);
     }
-    return *this;
-}
 
+    storage->oldTable = storage->table;
+    storage->oldCapacity = storage->capacity;
+    storage->movedBuckets = 0;
+    ++resizes;
 
-template <typename ElementType>
-HashSet<ElementType>& HashSet<ElementType>::operator=(HashSet&& s) noexcept
-{
-    std::swap(table, s.table);
-    std::swap(capacity, s.capacity);
-    std::swap(sz, s.sz);
-    return *this;
-}
+    storage->capacity = newCapacity;
+    storage->table = emptyTable(storage->capacity);
 
+    if (!incremental)
+    {
+        moveBuckets(storage->oldCapacity);
+    }
+}
 
-template <typename ElementType>
-bool HashSet<ElementType>::isImplemented() const noexcept
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::moveBuckets(unsigned int count)
 {
-    return true;
-}
+    // The existing nodes are relinked into the new table rather than
+    // copied, so moving a bucket allocates nothing.
+    for (; count > 0 && storage->movedBuckets < storage->oldCapacity; --count, ++storage->movedBuckets)
+    {
+        Node* curr = storage->oldTable[storage->movedBuckets];
+        while (curr != nullptr)
+        {
+            Node* next = curr->next;
+            unsigned int j = hashOf(curr) % storage->capacity;
+            curr->next = storage->table[j];
+            storage->table[j] = curr;
+            curr = next;
+        }
+        storage->oldTable[storage->movedBuckets] = nullptr;
+    }
 
+    if (storage->movedBuckets == storage->oldCapacity)
+    {
+        std::free(storage->oldTable);
+        storage->oldTable = nullptr;
+        storage->oldCapacity = 0;
+        storage->movedBuckets = 0;
+    }
+}
 
-template <typename ElementType>
-void HashSet<ElementType>::add(const ElementType& element)
+template <typename ElementType, typename Hasher>
+bool HashSet<ElementType, Hasher>::unlink(Node*& head, const ElementType& element, unsigned int hash)
 {
-    //std::cout << "ADD" << std::endl;
-
-    if (sz/capacity > 0.8)
+    for (Node** link = &head; *link != nullptr; link = &(*link)->next)
     {
-        Node* curr;
+        Node* curr = *link;
 
-        int newCapacity = capacity * 2;
-        Node** newTable = new Node* [newCapacity];
-        for (int i = 0; i < capacity; ++i)
+        if ((!CACHES_HASH || curr->hash == hash) && curr->element == element)
         {
-            curr = table[i];
-            if (curr != nullptr)
-            {
-                while(curr != nullptr)
-                {
-                    ElementType key = curr->element;
-                    unsigned int j = hashFunction(key) % newCapacity;
-                    newTable[j] = new Node(key, newTable[j]);
-                }
-            }
+            *link = curr->next;
+            storage->pool.destroy(curr);
+            return true;
         }
     }
 
-    unsigned int i = hashFunction(element) % capacity;
+    return false;
+}
+
+template <typename ElementType, typename Hasher>
+template <typename KeyType>
+bool HashSet<ElementType, Hasher>::containsHashed(const KeyType& key, unsigned int hash) const
+{
+    unsigned int probes = 0;
 
-    if (table[i] == nullptr)
+    if (filter == nullptr)
     {
-        table[i] = new Node(element);
-        ++sz;
+        bool found = tableContains(key, hash, probes);
+        countLookups(1, probes);
+        return found;
     }
-    else
+
+    if (!filter->mayContain(hash))
     {
-        Node* temp = table[i];
-        while (temp->next != nullptr)
-        {
-            if (temp->element == element)
-            {
-                return;
-            }
-            else
-            {
-                temp = temp->next;
-            }
-        }
-        temp->next = new Node(element, nullptr);
-        ++sz;
+        filterCounters.countRejection();
+        countLookups(1, 0);
+        return false;
     }
-    //printAll(table);
+
+    bool found = tableContains(key, hash, probes);
+    countLookups(1, probes);
+
+    if (!found)
+    {
+        filterCounters.countFalsePositive();
+    }
+
+    return found;
 }
 
+template <typename ElementType, typename Hasher>
+template <typename KeyType>
+bool HashSet<ElementType, Hasher>::tableContains(
+    const KeyType& key, unsigned int hash, unsigned int& probes) const
+{
+    if (chainContains(storage->table[hash % storage->capacity], key, hash, probes))
+    {
+        return true;
+    }
+
+    // Buckets that have already been moved are empty, so there's no need
+    // to check whether this one has been.
+    return storage->oldTable != nullptr
+        && chainContains(storage->oldTable[hash % storage->oldCapacity], key, hash, probes);
+}
 
-template <typename ElementType>
-bool HashSet<ElementType>::contains(const ElementType& element) const
+template <typename ElementType, typename Hasher>
+template <typename KeyType>
+bool HashSet<ElementType, Hasher>::chainContains(
+    Node* curr, const KeyType& key, unsigned int hash, unsigned int& probes) const
 {
-    unsigned int i = hashFunction(element) % capacity;
-    if (table[i] != nullptr)
+    while (curr != nullptr)
     {
-        while (table[i] != nullptr)
+        ++probes;
+
+        if ((!CACHES_HASH || curr->hash == hash) && curr->element == key)
         {
-            if (table[i]->element == element)
-            {
-                return true;
-            }
-            else
-            {
-                table[i] = table[i]->next;
-            }
-        }  
-    } 
+            return true;
+        }
+        else
+        {
+            curr = curr->next;
+        }
+    }
     return false;
 }
 
-
-template <typename ElementType>
-unsigned int HashSet<ElementType>::size() const noexcept
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::countLookups(unsigned int lookups, unsigned int probes) const noexcept
 {
-    //std::cout << "size: " << sz << std::endl;
-    return sz;
+    counters.count(lookups, probes);
 }
 
-
-template <typename ElementType>
-unsigned int HashSet<ElementType>::elementsAtIndex(unsigned int index) const
+template <typename ElementType, typename Hasher>
+void HashSet<ElementType, Hasher>::rebuildBloomFilter(unsigned int expectedKeys, unsigned int bitsPerKey)
 {
-    if (index < 0 || index >= capacity)
-    {
-        return 0;
-    }
-    else
-    {
-        int length = 0;
-        Node* curr = table[index];
-        while (curr != nullptr)
+    auto rebuilt = std::make_shared<BloomFilter>(expectedKeys, bitsPerKey);
+
+    auto insertChains = [&](Node** chains, unsigned int first, unsigned int last) {
+        for (unsigned int i = first; i < last; ++i)
         {
-            ++length;
-            curr = curr->next;
+            for (Node* curr = chains[i]; curr != nullptr; curr = curr->next)
+            {
+                rebuilt->insert(hashOf(curr));
+            }
         }
-        return length;
+    };
+
+    insertChains(storage->table, 0, storage->capacity);
+
+    if (storage->oldTable != nullptr)
+    {
+        insertChains(storage->oldTable, storage->movedBuckets, storage->oldCapacity);
     }
-}
 
+    filter = std::move(rebuilt);
+}
 
-template <typename ElementType>
-bool HashSet<ElementType>::isElementAtIndex(const ElementType& element, unsigned int index) const
+template <typename ElementType, typename Hasher>
+unsigned int HashSet<ElementType, Hasher>::hashOf(const Node* node) const
 {
-    if (index < 0 || index >= capacity)
+    if constexpr (CACHES_HASH)
     {
-        return 0;
+        return node->hash;
     }
     else
     {
-        Node* curr = table[index];
-        while (curr != nullptr)
-        {
-            if (curr->element == element)
-            {
-                return true;
-            }
-            else
+        return hasher(node->element);
+    }
+}
+
+template <typename ElementType, typename Hasher>
+template <typename ForwardIterator>
+std::vector<unsigned int> HashSet<ElementType, Hasher>::hashAll(
+    ForwardIterator first, unsigned int count) const
+{
+    std::vector<unsigned int> hashes(count);
+
+    // Each thread writes to its own part of hashes, so they share nothing
+    // but the (const) hasher.  Finding the start of a slice is only linear
+    // for iterators that aren't random-access, and then it's done by each
+    // thread in parallel.
+    impl_::HashSet__inParallel(
+        count, MIN_ELEMENTS_PER_THREAD,
+        [this, &hashes, first](unsigned int begin, unsigned int end) {
+            ForwardIterator curr = std::next(first, begin);
+            for (unsigned int i = begin; i < end; ++i, ++curr)
             {
-                curr = curr->next;
+                hashes[i] = hasher(*curr);
             }
-        }
-    return false;
-    }
+        });
+
+    return hashes;
 }
 
-template <typename ElementType>
-void HashSet<ElementType>::printAll(Node** table)
+
+// visitBuckets() calls visit(element) for each element in the buckets from
+// first up to (but not including) last, counting the buckets of the old
+// array after those of the current one, as Iterators do.
+template <typename ElementType, typename Hasher>
+template <typename Visitor>
+void HashSet<ElementType, Hasher>::visitBuckets(
+    unsigned int first, unsigned int last, Visitor& visit) const
 {
-    for (int i = 0; i < capacity; ++i)
+    for (unsigned int i = first; i < last && i < storage->capacity; ++i)
     {
-        std::cout << i << ": ";
-        Node* temp = table[i];
-        while (temp != nullptr)
+        for (Node* curr = storage->table[i]; curr != nullptr; curr = curr->next)
         {
-            std::cout << temp->element << " -> ";
-            temp = temp->next;
+            visit(static_cast<const ElementType&>(curr->element));
         }
-        std::cout << std::endl;
     }
-    std::cout << std::endl;
-}
 
-template <typename ElementType>
-void HashSet<ElementType>::destroyAll(Node** table)
-{
-    Node* temp;
-    Node* curr;
-    for (int i = 0; i < capacity; ++i)
+    if (last <= storage->capacity)
     {
-        curr = table[i];
+        return;
+    }
 
-        while (curr != nullptr)
+    // Buckets of the old array that have already been moved are empty,
+    // so they're skipped.
+    for (unsigned int i = std::max(first, storage->capacity + storage->movedBuckets) - storage->capacity;
+         i < last - storage->capacity && i < storage->oldCapacity; ++i)
+    {
+        for (Node* curr = storage->oldTable[i]; curr != nullptr; curr = curr->next)
         {
-            temp = curr;
-            delete temp;
-            curr = curr->next;
+            visit(static_cast<const ElementType&>(curr->element));
         }
-        table[i] = nullptr;
     }
-    //delete[] table;
 }
 
-template <typename ElementType>
-typename HashSet<ElementType>::Node** HashSet<ElementType>::copyAll(
-    Node** table, int capacity)
-{
-    Node** newHash = new Node* [capacity];
-
-    for (int i = 0; i < capacity; ++i)
-    {
-        //std::cout << "INDEX: " << i << std::endl;
-        Node* curr = table[i];
-        Node* newList = newHash[i];
-
-        if (curr != nullptr)
 
-            while (curr != nullptr)
+template <typename ElementType, typename Hasher>
+std::vector<const ElementType*> HashSet<ElementType, Hasher>::select(
+    const HashSet& candidates, bool present) const
+{
+    std::vector<const ElementType*> selected;
+    std::mutex selectedMutex;
+
+    // contains() never modifies the set, and visiting never modifies the
+    // candidates, so slices of the candidates' buckets can be looked up on
+    // several threads at once; only adding each slice's survivors to the
+    // result needs to be done one thread at a time.
+    impl_::HashSet__inParallel(
+        candidates.storage->capacity + candidates.storage->oldCapacity, MIN_ELEMENTS_PER_THREAD,
+        [this, &candidates, present, &selected, &selectedMutex](unsigned int first, unsigned int last) {
+            std::vector<const ElementType*> slice;
+            auto collect = [&slice](const ElementType& element) { slice.push_back(&element); };
+            candidates.visitBuckets(first, last, collect);
+
+            std::unique_ptr<bool[]> results{new bool[slice.size()]};
+            searchBatch(
+                [&slice](unsigned int i) -> const ElementType& { return *slice[i]; },
+                slice.size(), results.get());
+
+            unsigned int kept = 0;
+            for (unsigned int i = 0; i < slice.size(); ++i)
             {
-                newList = new Node{curr->element, newList};
-                //std::cout << curr->element << std::endl;
-                curr = curr->next;
+                if (results[i] == present)
+                {
+                    slice[kept++] = slice[i];
+                }
             }
-        else
-        { 
-            //std::cout << 0 << std::endl;
-            newList = nullptr;
-        }
-    }
-    return newHash;
+
+            std::lock_guard<std::mutex> lock{selectedMutex};
+            selected.insert(selected.end(), slice.begin(), slice.begin() + kept);
+        });
+
+    return selected;
 }
 
 
 #endif // HASHSET_HPP
-
@@ -0,0 +1,245 @@
+#ifndef HASHING_HPP
+#define HASHING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+
+// Hashing.hpp provides fast, well-distributed hash functions to use with
+// HashSet and the other hash-based sets, so that there's no need to write
+// one's own (and no temptation to use a poor one).
+//
+// hashing::hashBytes() is a byte-string hash in the style of wyhash: it
+// consumes its input eight bytes at a time, folding each pair of words
+// together with a 64x64 -> 128-bit multiplication, which mixes every input
+// bit into every output bit and runs at several bytes per cycle.  Short
+// keys (up to 16 bytes, which covers almost every word in a dictionary)
+// take a branch-light path that reads the key with at most four loads.
+//
+// hashing::mixInteger() is a 64-bit integer mixer (the MurmurHash3
+// finalizer), so that keys like 0, 1024, 2048, ..., which an identity hash
+// would pile into a few buckets, are spread across all of them.
+//
+// DefaultHasher, below, puts them together as the hasher that a HashSet
+// uses when it's declared as HashSet<ElementType, DefaultHasher<ElementType>>.
+
+namespace hashing
+{
+    namespace impl_
+    {
+        constexpr std::uint64_t SECRET[4] = {
+            0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+            0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+        };
+
+
+        // Multiplies a and b, leaving the low 64 bits of the product in a
+        // and the high 64 bits in b.
+        inline void multiply(std::uint64_t& a, std::uint64_t& b) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            __uint128_t product = static_cast<__uint128_t>(a) * b;
+            a = static_cast<std::uint64_t>(product);
+            b = static_cast<std::uint64_t>(product >> 64);
+#else
+            std::uint64_t aHigh = a >> 32, aLow = static_cast<std::uint32_t>(a);
+            std::uint64_t bHigh = b >> 32, bLow = static_cast<std::uint32_t>(b);
+            std::uint64_t high = aHigh * bHigh, middle0 = aHigh * bLow;
+            std::uint64_t middle1 = aLow * bHigh, low = aLow * bLow;
+            std::uint64_t carry = (low >> 32) + static_cast<std::uint32_t>(middle0)
+                + static_cast<std::uint32_t>(middle1);
+            a = low + (middle0 << 32) + (middle1 << 32);
+            b = high + (middle0 >> 32) + (middle1 >> 32) + (carry >> 32);
+#endif
+        }
+
+
+        inline std::uint64_t mix(std::uint64_t a, std::uint64_t b) noexcept
+        {
+            multiply(a, b);
+            return a ^ b;
+        }
+
+
+        inline std::uint64_t read8(const unsigned char* p) noexcept
+        {
+            std::uint64_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+
+        inline std::uint64_t read4(const unsigned char* p) noexcept
+        {
+            std::uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+
+        // Reads one to three bytes, touching the first, middle, and last.
+        inline std::uint64_t read3(const unsigned char* p, std::size_t length) noexcept
+        {
+            return (static_cast<std::uint64_t>(p[0]) << 16)
+                | (static_cast<std::uint64_t>(p[length >> 1]) << 8)
+                | p[length - 1];
+        }
+    }
+
+
+    // hashBytes() returns a 64-bit hash of the given bytes.  Different
+    // seeds give independent hash functions.
+    inline std::uint64_t hashBytes(
+        const void* data, std::size_t length, std::uint64_t seed = 0) noexcept
+    {
+        using namespace impl_;
+
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        seed ^= mix(seed ^ SECRET[0], SECRET[1]);
+
+        std::uint64_t a;
+        std::uint64_t b;
+
+        if (length <= 16)
+        {
+            if (length >= 4)
+            {
+                std::size_t middle = (length >> 3) << 2;
+                a = (read4(p) << 32) | read4(p + middle);
+                b = (read4(p + length - 4) << 32) | read4(p + length - 4 - middle);
+            }
+            else if (length > 0)
+            {
+                a = read3(p, length);
+                b = 0;
+            }
+            else
+            {
+                a = 0;
+                b = 0;
+            }
+        }
+        else
+        {
+            std::size_t remaining = length;
+
+            // Long inputs are consumed in three independent lanes, so that
+            // the multiplications can overlap.
+            if (remaining > 48)
+            {
+                std::uint64_t seed1 = seed;
+                std::uint64_t seed2 = seed;
+
+                do
+                {
+                    seed = mix(read8(p) ^ SECRET[1], read8(p + 8) ^ seed);
+                    seed1 = mix(read8(p + 16) ^ SECRET[2], read8(p + 24) ^ seed1);
+                    seed2 = mix(read8(p + 32) ^ SECRET[3], read8(p + 40) ^ seed2);
+                    p += 48;
+                    remaining -= 48;
+                }
+                while (remaining > 48);
+
+                seed ^= seed1 ^ seed2;
+            }
+
+            while (remaining > 16)
+            {
+                seed = mix(read8(p) ^ SECRET[1], read8(p + 8) ^ seed);
+                p += 16;
+                remaining -= 16;
+            }
+
+            a = read8(p + remaining - 16);
+            b = read8(p + remaining - 8);
+        }
+
+        a ^= SECRET[1];
+        b ^= seed;
+        multiply(a, b);
+        return mix(a ^ SECRET[0] ^ length, b ^ SECRET[1]);
+    }
+
+
+    // mixInteger() scrambles the bits of an integer so that every bit of
+    // the result depends on every bit of the input.
+    inline std::uint64_t mixInteger(std::uint64_t key) noexcept
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdull;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ull;
+        key ^= key >> 33;
+        return key;
+    }
+
+
+    // fold() reduces a 64-bit hash to the unsigned int that the sets use,
+    // keeping the influence of all 64 bits.
+    inline unsigned int fold(std::uint64_t hash) noexcept
+    {
+        return static_cast<unsigned int>(hash ^ (hash >> 32));
+    }
+
+
+    // hashString() and hashInteger() are the above, folded, in a form that
+    // can be passed anywhere a hash function is expected, such as to the
+    // constructor of a HashSet<std::string> or HashSet<int>.
+    inline unsigned int hashString(std::string_view s) noexcept
+    {
+        return fold(hashBytes(s.data(), s.size()));
+    }
+
+
+    inline unsigned int hashInteger(std::uint64_t key) noexcept
+    {
+        return fold(mixInteger(key));
+    }
+}
+
+
+
+// DefaultHasher<ElementType> is a stateless hasher that hashes integers
+// and enumerations with hashing::mixInteger() and anything else with
+// std::hash, followed by hashing::mixInteger() (since std::hash is often
+// the identity function).  For std::string, it's transparent, hashing a
+// std::string_view with hashing::hashBytes(), so that a HashSet<std::string>
+// using it can be searched for a std::string_view or a const char*.
+
+template <typename ElementType>
+struct DefaultHasher
+{
+    unsigned int operator()(const ElementType& element) const noexcept
+    {
+        if constexpr (std::is_integral<ElementType>::value || std::is_enum<ElementType>::value)
+        {
+            return hashing::hashInteger(static_cast<std::uint64_t>(element));
+        }
+        else
+        {
+            return hashing::hashInteger(std::hash<ElementType>{}(element));
+        }
+    }
+};
+
+
+template <>
+struct DefaultHasher<std::string>
+{
+    using is_transparent = void;
+
+    unsigned int operator()(std::string_view key) const noexcept
+    {
+        return hashing::hashString(key);
+    }
+};
+
+
+
+#endif // HASHING_HPP
+
@@ -0,0 +1,226 @@
+#include "InlineStringHashSet.hpp"
+#include <cstring>
+#include <utility>
+#include "Hashing.hpp"
+
+
+namespace
+{
+    // A long string's slot holds its offset in the arena, followed by its
+    // length.
+    struct LongString
+    {
+        std::uint64_t offset;
+        std::uint32_t length;
+    };
+}
+
+
+InlineStringHashSet::Slot::Slot()
+    : hash{0}, length{EMPTY}
+{
+}
+
+
+InlineStringHashSet::InlineStringHashSet()
+    : slots(DEFAULT_CAPACITY), arenaGarbage{0}, sz{0}
+{
+}
+
+
+bool InlineStringHashSet::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+void InlineStringHashSet::add(const std::string& element)
+{
+    std::uint32_t hash = hashing::hashString(element);
+
+    if (find(element, hash) != NOT_FOUND)
+    {
+        return;
+    }
+
+    if (sz + 1 > slots.size() * 0.8)
+    {
+        rebuild(slots.size() * 2);
+    }
+
+    place(element, hash);
+    ++sz;
+}
+
+
+void InlineStringHashSet::remove(const std::string& element)
+{
+    std::size_t hole = find(element, hashing::hashString(element));
+
+    if (hole == NOT_FOUND)
+    {
+        return;
+    }
+
+    if (slots[hole].length == LONG)
+    {
+        arenaGarbage += longString(slots[hole]).size();
+    }
+
+    // Each later slot in the run moves back into the hole unless its home
+    // slot lies (cyclically) after the hole, in which case moving it would
+    // put it before its home, where lookups would never find it.
+    std::size_t mask = slots.size() - 1;
+
+    for (std::size_t i = (hole + 1) & mask; slots[i].length != EMPTY; i = (i + 1) & mask)
+    {
+        std::size_t home = slots[i].hash & mask;
+
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            slots[hole] = slots[i];
+            hole = i;
+        }
+    }
+
+    slots[hole] = Slot{};
+    --sz;
+
+    if (sz < slots.size() * 0.2 && slots.size() > DEFAULT_CAPACITY)
+    {
+        rebuild(slots.size() / 2);
+    }
+    else if (arenaGarbage > arena.size() / 2)
+    {
+        rebuild(slots.size());
+    }
+}
+
+
+bool InlineStringHashSet::contains(const std::string& element) const
+{
+    return contains(std::string_view{element});
+}
+
+
+bool InlineStringHashSet::contains(std::string_view key) const noexcept
+{
+    return find(key, hashing::hashString(key)) != NOT_FOUND;
+}
+
+
+bool InlineStringHashSet::contains(const char* key) const noexcept
+{
+    return contains(std::string_view{key});
+}
+
+
+unsigned int InlineStringHashSet::size() const noexcept
+{
+    return sz;
+}
+
+
+unsigned int InlineStringHashSet::slotCount() const noexcept
+{
+    return slots.size();
+}
+
+
+unsigned int InlineStringHashSet::arenaSize() const noexcept
+{
+    return arena.size();
+}
+
+
+std::size_t InlineStringHashSet::find(std::string_view key, std::uint32_t hash) const noexcept
+{
+    std::size_t mask = slots.size() - 1;
+
+    for (std::size_t i = hash & mask; ; i = (i + 1) & mask)
+    {
+        const Slot& slot = slots[i];
+
+        if (slot.length == EMPTY)
+        {
+            return NOT_FOUND;
+        }
+
+        if (slot.hash != hash)
+        {
+            continue;
+        }
+
+        if (slot.length == LONG
+            ? longString(slot) == key
+            : slot.length == key.size() && std::memcmp(slot.bytes, key.data(), key.size()) == 0)
+        {
+            return i;
+        }
+    }
+}
+
+
+std::string_view InlineStringHashSet::longString(const Slot& slot) const noexcept
+{
+    LongString location;
+    std::memcpy(&location, slot.bytes, sizeof(LongString));
+    return std::string_view{arena}.substr(location.offset, location.length);
+}
+
+
+// place() stores a string that isn't in the set in the first empty slot of
+// its probe sequence.  The table must have room for it.
+void InlineStringHashSet::place(std::string_view key, std::uint32_t hash)
+{
+    std::size_t mask = slots.size() - 1;
+    std::size_t i = hash & mask;
+
+    while (slots[i].length != EMPTY)
+    {
+        i = (i + 1) & mask;
+    }
+
+    Slot& slot = slots[i];
+
+    if (key.size() <= INLINE_CAPACITY)
+    {
+        slot.length = static_cast<std::uint8_t>(key.size());
+        std::memcpy(slot.bytes, key.data(), key.size());
+    }
+    else
+    {
+        LongString location{arena.size(), static_cast<std::uint32_t>(key.size())};
+        arena.append(key.data(), key.size());
+        slot.length = LONG;
+        std::memcpy(slot.bytes, &location, sizeof(LongString));
+    }
+
+    slot.hash = hash;
+}
+
+
+// rebuild() moves every string into a new table with the given number of
+// slots, and a new arena holding only the long strings that are still in
+// the set.  The hashes are kept in the slots, so nothing is rehashed.
+void InlineStringHashSet::rebuild(std::size_t newSlotCount)
+{
+    InlineStringHashSet rebuilt;
+    rebuilt.slots.assign(newSlotCount, Slot{});
+    rebuilt.arena.reserve(arena.size() - arenaGarbage);
+
+    for (const Slot& slot : slots)
+    {
+        if (slot.length == LONG)
+        {
+            rebuilt.place(longString(slot), slot.hash);
+        }
+        else if (slot.length != EMPTY)
+        {
+            rebuilt.place(std::string_view{slot.bytes, slot.length}, slot.hash);
+        }
+    }
+
+    rebuilt.sz = sz;
+    *this = std::move(rebuilt);
+}
@@ -0,0 +1,133 @@
+#ifndef INLINESTRINGHASHSET_HPP
+#define INLINESTRINGHASHSET_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Set.hpp"
+
+
+
+// An InlineStringHashSet is a set of strings laid out so that most
+// lookups touch a single cache line.  A HashSet<std::string> keeps each
+// element in a node of its own, so finding one means following a pointer
+// to the node and then, for anything too long for std::string's own
+// small buffer, another to the string's characters.  Here, instead, the
+// table is one flat array of 32-byte slots (two to a cache line), using
+// linear probing, and each slot holds the string's hash, its length, and,
+// when it's no longer than INLINE_CAPACITY bytes, the string itself.
+// Since most words are that short, a lookup usually compares the key
+// against bytes in the very cache line it probed.
+//
+// Longer strings are kept in an "overflow arena": one contiguous buffer
+// holding all of them, end to end, with their slots recording where each
+// one is.  The arena is compacted whenever the table is rebuilt, and
+// whenever more than half of it belongs to strings that were removed.
+//
+// Strings are hashed with hashing::hashString() (see Hashing.hpp).
+
+class InlineStringHashSet : public Set<std::string>
+{
+public:
+    // The longest string that's stored in its slot, rather than in the
+    // overflow arena.
+    static constexpr unsigned int INLINE_CAPACITY = 27;
+
+    // The number of slots before anything has been added.  Slot counts are
+    // always a power of two.
+    static constexpr unsigned int DEFAULT_CAPACITY = 16;
+
+public:
+    // Initializes an InlineStringHashSet to be empty.
+    InlineStringHashSet();
+
+    // An InlineStringHashSet can be copied, moved, and assigned like any
+    // other set; the default versions of these do the right thing.
+    virtual ~InlineStringHashSet() noexcept = default;
+    InlineStringHashSet(const InlineStringHashSet& s) = default;
+    InlineStringHashSet(InlineStringHashSet&& s) noexcept = default;
+    InlineStringHashSet& operator=(const InlineStringHashSet& s) = default;
+    InlineStringHashSet& operator=(InlineStringHashSet&& s) noexcept = default;
+
+
+    // isImplemented() returns true, since an InlineStringHashSet is fully
+    // implemented.
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds a string to the set.  If the string is already in the set,
+    // this function has no effect.  This function triggers a rebuilding of
+    // the table, twice as large, when the ratio of size to capacity would
+    // exceed 0.8, in which case it runs in linear time; otherwise, it runs
+    // in constant time (assuming a good hash function).
+    virtual void add(const std::string& element) override;
+
+
+    // remove() removes a string from the set.  If the string isn't in the
+    // set, this function has no effect.  The slots after it in its probe
+    // sequence are shifted back, so no "tombstone" is left behind to slow
+    // down later lookups.  When the ratio of size to capacity falls below
+    // 0.2, the table is rebuilt at half the size (down to DEFAULT_CAPACITY).
+    void remove(const std::string& element);
+
+
+    // contains() returns true if the given string is in the set, false
+    // otherwise.  This function runs in constant time (assuming a good
+    // hash function).
+    virtual bool contains(const std::string& element) const override;
+
+
+    // These versions of contains() search for a std::string_view or a
+    // C-style string, so that no std::string needs to be constructed.
+    bool contains(std::string_view key) const noexcept;
+    bool contains(const char* key) const noexcept;
+
+
+    // size() returns the number of strings in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // slotCount() returns the number of slots in the table.
+    unsigned int slotCount() const noexcept;
+
+
+    // arenaSize() returns the number of bytes in the overflow arena,
+    // including any that belong to strings that have been removed.
+    unsigned int arenaSize() const noexcept;
+
+
+private:
+    // A slot's length is EMPTY when it's unused, LONG when its string is in
+    // the arena (in which case bytes holds the string's offset and length
+    // there), and otherwise the length of the string in bytes.
+    static constexpr std::uint8_t EMPTY = 0xFF;
+    static constexpr std::uint8_t LONG = 0xFE;
+
+    struct alignas(32) Slot
+    {
+        std::uint32_t hash;
+        std::uint8_t length;
+        char bytes[INLINE_CAPACITY];
+
+        Slot();
+    };
+
+    std::vector<Slot> slots;
+    std::string arena;
+    unsigned int arenaGarbage;
+    unsigned int sz;
+
+
+private:
+    static constexpr std::size_t NOT_FOUND = static_cast<std::size_t>(-1);
+
+    std::size_t find(std::string_view key, std::uint32_t hash) const noexcept;
+    std::string_view longString(const Slot& slot) const noexcept;
+    void place(std::string_view key, std::uint32_t hash);
+    void rebuild(std::size_t newSlotCount);
+};
+
+
+
+#endif // INLINESTRINGHASHSET_HPP
@@ -0,0 +1,308 @@
+#include "MappedHashSet.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Hashing.hpp"
+
+
+namespace
+{
+    constexpr char MAGIC[8] = {'D', 'S', 'H', 'A', 'S', 'H', 'S', 'T'};
+    constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+    constexpr std::uint32_t VERSION = 1;
+
+
+    // Sections of the image start on eight-byte boundaries, so that every
+    // field in them is properly aligned.
+    std::uint64_t alignUp(std::uint64_t offset)
+    {
+        return (offset + 7) & ~std::uint64_t{7};
+    }
+}
+
+
+MappedHashSet::MappedHashSet(const std::string& path)
+    : image{nullptr}, imageSize{0}, starts{nullptr}, entries{nullptr},
+      bytes{nullptr}, byteCount{0}, sz{0}, buckets{0}
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error{"cannot open " + path};
+    }
+
+    struct stat status;
+    if (::fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(Header))
+    {
+        ::close(fd);
+        throw std::runtime_error{path + " is not a HashSet image"};
+    }
+
+    imageSize = status.st_size;
+    void* mapping = ::mmap(nullptr, imageSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        throw std::runtime_error{"cannot map " + path};
+    }
+
+    image = static_cast<const unsigned char*>(mapping);
+
+    // Only the header is checked, so that opening an image takes the same
+    // time no matter how large it is; contains() checks the bucket starts
+    // and entries it reads against the sizes the header gives.
+    Header header;
+    std::memcpy(&header, image, sizeof(Header));
+
+    bool valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+        && header.byteOrder == BYTE_ORDER_MARK
+        && header.version == VERSION
+        && header.fileSize == imageSize
+        && header.bucketCount != 0
+        && (header.bucketCount & (header.bucketCount - 1)) == 0
+        && header.startsOffset % 8 == 0
+        && header.entriesOffset % 8 == 0
+        && header.startsOffset + (header.bucketCount + std::uint64_t{1}) * sizeof(std::uint32_t)
+            <= header.entriesOffset
+        && header.entriesOffset + std::uint64_t{header.elementCount} * sizeof(Entry)
+            <= header.bytesOffset
+        && header.bytesOffset <= imageSize;
+
+    if (!valid)
+    {
+        unmap();
+        throw std::runtime_error{path + " is not a HashSet image"};
+    }
+
+    starts = reinterpret_cast<const std::uint32_t*>(image + header.startsOffset);
+    entries = reinterpret_cast<const Entry*>(image + header.entriesOffset);
+    bytes = reinterpret_cast<const char*>(image + header.bytesOffset);
+    byteCount = imageSize - header.bytesOffset;
+    sz = header.elementCount;
+    buckets = header.bucketCount;
+}
+
+
+MappedHashSet::~MappedHashSet() noexcept
+{
+    unmap();
+}
+
+
+MappedHashSet::MappedHashSet(MappedHashSet&& s) noexcept
+    : image{nullptr}, imageSize{0}, starts{nullptr}, entries{nullptr},
+      bytes{nullptr}, byteCount{0}, sz{0}, buckets{0}
+{
+    *this = std::move(s);
+}
+
+
+MappedHashSet& MappedHashSet::operator=(MappedHashSet&& s) noexcept
+{
+    std::swap(image, s.image);
+    std::swap(imageSize, s.imageSize);
+    std::swap(starts, s.starts);
+    std::swap(entries, s.entries);
+    std::swap(bytes, s.bytes);
+    std::swap(byteCount, s.byteCount);
+    std::swap(sz, s.sz);
+    std::swap(buckets, s.buckets);
+    return *this;
+}
+
+
+void MappedHashSet::writeImage(const std::vector<std::string>& elements, const std::string& path)
+{
+    // Sorting by hash groups each bucket's entries together (the bucket
+    // is the low bits of the hash, so sort by those first) and puts
+    // duplicates next to each other.
+    std::vector<std::pair<std::uint32_t, const std::string*>> sorted;
+    sorted.reserve(elements.size());
+    for (const std::string& element : elements)
+    {
+        sorted.emplace_back(hashing::hashString(element), &element);
+    }
+
+    std::uint32_t bucketCount = 1;
+    while (bucketCount < sorted.size() && bucketCount < (1u << 31))
+    {
+        bucketCount *= 2;
+    }
+
+    std::uint32_t mask = bucketCount - 1;
+    std::sort(
+        sorted.begin(), sorted.end(),
+        [mask](const auto& a, const auto& b) {
+            return (a.first & mask) != (b.first & mask)
+                ? (a.first & mask) < (b.first & mask)
+                : a.first != b.first ? a.first < b.first : *a.second < *b.second;
+        });
+
+    sorted.erase(
+        std::unique(
+            sorted.begin(), sorted.end(),
+            [](const auto& a, const auto& b) { return *a.second == *b.second; }),
+        sorted.end());
+
+    std::vector<std::uint32_t> starts(bucketCount + 1, 0);
+    std::vector<Entry> entries;
+    entries.reserve(sorted.size());
+    std::uint64_t byteCount = 0;
+
+    for (const auto& [hash, element] : sorted)
+    {
+        ++starts[(hash & mask) + 1];
+        entries.push_back(Entry{hash, static_cast<std::uint32_t>(element->size()), byteCount});
+        byteCount += element->size();
+    }
+
+    for (std::uint32_t i = 0; i < bucketCount; ++i)
+    {
+        starts[i + 1] += starts[i];
+    }
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.version = VERSION;
+    header.elementCount = entries.size();
+    header.bucketCount = bucketCount;
+    header.startsOffset = alignUp(sizeof(Header));
+    header.entriesOffset = alignUp(header.startsOffset + starts.size() * sizeof(std::uint32_t));
+    header.bytesOffset = alignUp(header.entriesOffset + entries.size() * sizeof(Entry));
+    header.fileSize = header.bytesOffset + byteCount;
+
+    // The image is written to a temporary file, which then replaces the
+    // old one by renaming.  Truncating the old file in place would pull
+    // the pages out from under any process that has it mapped; renaming
+    // leaves those processes with the old file until they unmap it.
+    std::string temporaryPath = path + ".tmp";
+    std::ofstream out{temporaryPath, std::ios::binary | std::ios::trunc};
+    if (!out)
+    {
+        throw std::runtime_error{"cannot write " + temporaryPath};
+    }
+
+    auto writeAt = [&out](std::uint64_t offset, const void* data, std::size_t size) {
+        static const char padding[8] = {};
+        out.write(padding, offset - static_cast<std::uint64_t>(out.tellp()));
+        out.write(static_cast<const char*>(data), size);
+    };
+
+    writeAt(0, &header, sizeof(Header));
+    writeAt(header.startsOffset, starts.data(), starts.size() * sizeof(std::uint32_t));
+    writeAt(header.entriesOffset, entries.data(), entries.size() * sizeof(Entry));
+    out.seekp(header.bytesOffset);
+
+    for (const auto& entry : sorted)
+    {
+        out.write(entry.second->data(), entry.second->size());
+    }
+
+    out.close();
+    if (!out)
+    {
+        std::remove(temporaryPath.c_str());
+        throw std::runtime_error{"cannot write " + temporaryPath};
+    }
+
+    // The data has to reach the disk before the rename does, or a crash
+    // in between could leave path naming a file with missing contents.
+    int fd = ::open(temporaryPath.c_str(), O_RDONLY);
+    bool synced = fd >= 0 && ::fsync(fd) == 0;
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+
+    if (!synced || std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temporaryPath.c_str());
+        throw std::runtime_error{"cannot write " + path};
+    }
+}
+
+
+bool MappedHashSet::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+void MappedHashSet::add(const std::string&)
+{
+    throw std::logic_error{"a MappedHashSet cannot be modified"};
+}
+
+
+bool MappedHashSet::contains(const std::string& element) const
+{
+    return contains(std::string_view{element});
+}
+
+
+bool MappedHashSet::contains(std::string_view key) const noexcept
+{
+    if (sz == 0)
+    {
+        return false;
+    }
+
+    std::uint32_t hash = hashing::hashString(key);
+    std::uint32_t bucket = hash & (buckets - 1);
+
+    // A corrupt image can't make the search read outside of it: the
+    // bucket's entries are limited to those the header counts, and an
+    // entry's bytes are only compared if they lie within the image.
+    std::uint32_t end = std::min<std::uint32_t>(starts[bucket + 1], sz);
+
+    for (std::uint32_t i = starts[bucket]; i < end; ++i)
+    {
+        const Entry& entry = entries[i];
+
+        if (entry.hash == hash && entry.length == key.size()
+            && entry.offset <= byteCount && entry.length <= byteCount - entry.offset
+            && std::memcmp(bytes + entry.offset, key.data(), key.size()) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+bool MappedHashSet::contains(const char* key) const noexcept
+{
+    return contains(std::string_view{key});
+}
+
+
+unsigned int MappedHashSet::size() const noexcept
+{
+    return sz;
+}
+
+
+unsigned int MappedHashSet::bucketCount() const noexcept
+{
+    return buckets;
+}
+
+
+void MappedHashSet::unmap() noexcept
+{
+    if (image != nullptr)
+    {
+        ::munmap(const_cast<unsigned char*>(image), imageSize);
+        image = nullptr;
+    }
+}
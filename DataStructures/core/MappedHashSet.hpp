@@ -0,0 +1,145 @@
+#ifndef MAPPEDHASHSET_HPP
+#define MAPPEDHASHSET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "HashSet.hpp"
+#include "Set.hpp"
+
+
+
+// A MappedHashSet is a read-only set of strings that lives in a binary
+// "image" file, which is memory-mapped rather than read.  Opening one does
+// no parsing and allocates nothing in proportion to its size; contains()
+// works directly on the mapped pages, which the operating system loads on
+// demand and shares between every process that maps the same file.  So a
+// large dictionary can be written once, with writeImage(), and then opened
+// almost instantly by every program that needs it.
+//
+// An image holds no pointers, only offsets, so it can be mapped at any
+// address.  It's laid out as
+//
+//   * a Header, identifying the file and giving the sizes of what follows;
+//   * bucketCount + 1 bucket starts: the entries of bucket b are those
+//     with indexes from starts[b] up to (but not including) starts[b + 1];
+//   * one Entry per string, giving its hash and where its bytes are; and
+//   * the bytes of all of the strings, one after another.
+//
+// Strings are hashed with hashing::hashString(), which gives the same
+// result in every process, and the bucket count is a power of two.  Images
+// use the byte order of the machine that wrote them; opening one written
+// with the other byte order fails, as does opening any file that isn't an
+// image.
+
+class MappedHashSet : public Set<std::string>
+{
+public:
+    // Opens and maps the image in the given file.  If the file can't be
+    // opened or mapped, or isn't a valid image, std::runtime_error is thrown.
+    explicit MappedHashSet(const std::string& path);
+
+    // Unmaps the image.
+    virtual ~MappedHashSet() noexcept;
+
+    // A MappedHashSet can be moved but not copied, since it owns its
+    // mapping; the expiring one is left empty.
+    MappedHashSet(const MappedHashSet& s) = delete;
+    MappedHashSet(MappedHashSet&& s) noexcept;
+    MappedHashSet& operator=(const MappedHashSet& s) = delete;
+    MappedHashSet& operator=(MappedHashSet&& s) noexcept;
+
+
+    // writeImage() writes an image containing the given strings (each
+    // only once, even if it appears more than once) to the given file,
+    // replacing whatever was there.  The image is written to a file with
+    // ".tmp" appended to its name, synced to disk, and then renamed into
+    // place, so processes that already have the old image mapped keep
+    // reading it undisturbed.  If the file can't be written,
+    // std::runtime_error is thrown.
+    static void writeImage(const std::vector<std::string>& elements, const std::string& path);
+
+    // This version of writeImage() writes an image containing the elements
+    // of a HashSet.
+    template <typename Hasher>
+    static void writeImage(const HashSet<std::string, Hasher>& s, const std::string& path);
+
+
+    // isImplemented() returns true, since a MappedHashSet is fully
+    // implemented.
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() throws a std::logic_error, since an image can't be changed
+    // once it's written.
+    virtual void add(const std::string& element) override;
+
+
+    // contains() returns true if the given string is in the image, false
+    // otherwise.  This function runs in constant time (assuming the image
+    // is well-distributed, which hashing::hashString() sees to).
+    virtual bool contains(const std::string& element) const override;
+
+
+    // These versions of contains() search for a std::string_view or a
+    // C-style string, so that no std::string needs to be constructed.
+    bool contains(std::string_view key) const noexcept;
+    bool contains(const char* key) const noexcept;
+
+
+    // size() returns the number of strings in the image.
+    virtual unsigned int size() const noexcept override;
+
+
+    // bucketCount() returns the number of buckets in the image.
+    unsigned int bucketCount() const noexcept;
+
+
+private:
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t byteOrder;
+        std::uint32_t version;
+        std::uint32_t elementCount;
+        std::uint32_t bucketCount;
+        std::uint64_t startsOffset;
+        std::uint64_t entriesOffset;
+        std::uint64_t bytesOffset;
+        std::uint64_t fileSize;
+    };
+
+    struct Entry
+    {
+        std::uint32_t hash;
+        std::uint32_t length;
+        std::uint64_t offset;
+    };
+
+    const unsigned char* image;
+    std::size_t imageSize;
+    const std::uint32_t* starts;
+    const Entry* entries;
+    const char* bytes;
+    std::uint64_t byteCount;
+    unsigned int sz;
+    unsigned int buckets;
+
+
+private:
+    void unmap() noexcept;
+};
+
+
+
+template <typename Hasher>
+void MappedHashSet::writeImage(const HashSet<std::string, Hasher>& s, const std::string& path)
+{
+    writeImage(s.elements(), path);
+}
+
+
+
+#endif // MAPPEDHASHSET_HPP
@@ -0,0 +1,268 @@
+#ifndef NODEPOOL_HPP
+#define NODEPOOL_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+
+// A NodePool hands out memory for nodes of one type, carving them out of
+// large "slabs" rather than asking for each one separately.  Creating a
+// node is usually nothing more than bumping a pointer, nodes that are
+// created together end up next to each other in memory, and destroying
+// the pool returns every slab at once, without visiting the nodes.  Nodes
+// that are released individually are kept on a free list and reused.
+//
+// The slabs themselves come from a std::pmr::memory_resource, so a pool
+// can be backed by an arena (e.g., a std::pmr::monotonic_buffer_resource)
+// or by anything else the caller likes; by default, it uses the default
+// memory resource, which is ordinarily new and delete.
+//
+// Note that a NodePool only manages memory.  When it's destroyed (or
+// releaseAll() is called), the nodes in it are not destroyed, so it's up
+// to the owner to destroy any nodes whose destructors need to run first.
+
+template <typename NodeType>
+class NodePool
+{
+public:
+    // The number of nodes in the first slab.  Each subsequent slab is twice
+    // the size of the one before it, up to MAX_SLAB_NODES.
+    static constexpr std::size_t FIRST_SLAB_NODES = 16;
+    static constexpr std::size_t MAX_SLAB_NODES = 4096;
+
+public:
+    // Initializes a NodePool that takes its slabs from the given memory
+    // resource.
+    explicit NodePool(
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept;
+
+    // Returns every slab to the memory resource.
+    ~NodePool() noexcept;
+
+    // A NodePool can't be copied, since the nodes in it belong to whoever
+    // created them, but it can be moved, which leaves the expiring one
+    // empty.
+    NodePool(const NodePool& pool) = delete;
+    NodePool(NodePool&& pool) noexcept;
+    NodePool& operator=(const NodePool& pool) = delete;
+    NodePool& operator=(NodePool&& pool) noexcept;
+
+
+    // create() constructs a node from the given arguments, in memory taken
+    // from the pool, and returns a pointer to it.
+    template <typename... Args>
+    NodeType* create(Args&&... args);
+
+
+    // destroy() destroys a node that was created by this pool, keeping its
+    // memory to be reused by a later call to create().
+    void destroy(NodeType* node) noexcept;
+
+
+    // releaseAll() returns every slab to the memory resource without
+    // destroying the nodes in them, leaving the pool empty.
+    void releaseAll() noexcept;
+
+
+    // resource() returns the memory resource that slabs are taken from.
+    std::pmr::memory_resource* resource() const noexcept;
+
+
+    // swap() exchanges the contents of two pools.
+    void swap(NodePool& other) noexcept;
+
+
+private:
+    // A slot is big enough to hold either a node or, while it's on the
+    // free list, a pointer to the next free slot.
+    union Slot
+    {
+        Slot* nextFree;
+        alignas(NodeType) unsigned char node[sizeof(NodeType)];
+    };
+
+    // Each slab begins with a header linking it to the previously
+    // allocated slab, followed by its slots.
+    struct Slab
+    {
+        Slab* previous;
+        std::size_t slotCount;
+
+        Slot* slots() noexcept;
+    };
+
+    static constexpr std::size_t SLAB_ALIGNMENT =
+        alignof(Slab) > alignof(Slot) ? alignof(Slab) : alignof(Slot);
+
+    std::pmr::memory_resource* memory;
+    Slab* slabs;
+    Slot* next;
+    Slot* end;
+    Slot* freeSlots;
+    std::size_t nextSlabNodes;
+
+
+private:
+    Slot* allocateSlot();
+    static std::size_t slabBytes(std::size_t slotCount) noexcept;
+    static std::size_t slotsOffset() noexcept;
+};
+
+
+
+template <typename NodeType>
+typename NodePool<NodeType>::Slot* NodePool<NodeType>::Slab::slots() noexcept
+{
+    return reinterpret_cast<Slot*>(reinterpret_cast<unsigned char*>(this) + slotsOffset());
+}
+
+
+template <typename NodeType>
+NodePool<NodeType>::NodePool(std::pmr::memory_resource* resource) noexcept
+    : memory{resource}, slabs{nullptr}, next{nullptr}, end{nullptr},
+      freeSlots{nullptr}, nextSlabNodes{FIRST_SLAB_NODES}
+{
+}
+
+
+template <typename NodeType>
+NodePool<NodeType>::~NodePool() noexcept
+{
+    releaseAll();
+}
+
+
+template <typename NodeType>
+NodePool<NodeType>::NodePool(NodePool&& pool) noexcept
+    : NodePool{pool.memory}
+{
+    swap(pool);
+}
+
+
+template <typename NodeType>
+NodePool<NodeType>& NodePool<NodeType>::operator=(NodePool&& pool) noexcept
+{
+    swap(pool);
+    return *this;
+}
+
+
+template <typename NodeType>
+template <typename... Args>
+NodeType* NodePool<NodeType>::create(Args&&... args)
+{
+    Slot* slot = allocateSlot();
+
+    try
+    {
+        return new (slot->node) NodeType(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        slot->nextFree = freeSlots;
+        freeSlots = slot;
+        throw;
+    }
+}
+
+
+template <typename NodeType>
+void NodePool<NodeType>::destroy(NodeType* node) noexcept
+{
+    node->~NodeType();
+
+    Slot* slot = reinterpret_cast<Slot*>(node);
+    slot->nextFree = freeSlots;
+    freeSlots = slot;
+}
+
+
+template <typename NodeType>
+void NodePool<NodeType>::releaseAll() noexcept
+{
+    while (slabs != nullptr)
+    {
+        Slab* previous = slabs->previous;
+        memory->deallocate(slabs, slabBytes(slabs->slotCount), SLAB_ALIGNMENT);
+        slabs = previous;
+    }
+
+    next = nullptr;
+    end = nullptr;
+    freeSlots = nullptr;
+    nextSlabNodes = FIRST_SLAB_NODES;
+}
+
+
+template <typename NodeType>
+std::pmr::memory_resource* NodePool<NodeType>::resource() const noexcept
+{
+    return memory;
+}
+
+
+template <typename NodeType>
+void NodePool<NodeType>::swap(NodePool& other) noexcept
+{
+    std::swap(memory, other.memory);
+    std::swap(slabs, other.slabs);
+    std::swap(next, other.next);
+    std::swap(end, other.end);
+    std::swap(freeSlots, other.freeSlots);
+    std::swap(nextSlabNodes, other.nextSlabNodes);
+}
+
+
+template <typename NodeType>
+typename NodePool<NodeType>::Slot* NodePool<NodeType>::allocateSlot()
+{
+    if (freeSlots != nullptr)
+    {
+        Slot* slot = freeSlots;
+        freeSlots = slot->nextFree;
+        return slot;
+    }
+
+    if (next == end)
+    {
+        void* memoryForSlab = memory->allocate(slabBytes(nextSlabNodes), SLAB_ALIGNMENT);
+
+        Slab* slab = static_cast<Slab*>(memoryForSlab);
+        slab->previous = slabs;
+        slab->slotCount = nextSlabNodes;
+        slabs = slab;
+
+        next = slab->slots();
+        end = next + slab->slotCount;
+
+        if (nextSlabNodes < MAX_SLAB_NODES)
+        {
+            nextSlabNodes *= 2;
+        }
+    }
+
+    return next++;
+}
+
+
+template <typename NodeType>
+std::size_t NodePool<NodeType>::slabBytes(std::size_t slotCount) noexcept
+{
+    return slotsOffset() + slotCount * sizeof(Slot);
+}
+
+
+template <typename NodeType>
+std::size_t NodePool<NodeType>::slotsOffset() noexcept
+{
+    // The slots start at the first suitably-aligned offset after the header.
+    return (sizeof(Slab) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+}
+
+
+
+#endif // NODEPOOL_HPP
+
@@ -0,0 +1,434 @@
+#ifndef RCUHASHSET_HPP
+#define RCUHASHSET_HPP
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "HashSet.hpp"
+#include "Set.hpp"
+
+
+// An RcuHashSet is a hash set for data that's read far more often than
+// it's changed, shared between threads.  It uses "read-copy-update": the
+// buckets and the nodes in them are only ever published, with atomic
+// stores, and never changed in place in any way a reader could notice, so
+// contains() takes no lock at all.  It does a fixed amount of work (beyond
+// searching the chain itself), without ever waiting for another thread,
+// so it's wait-free.
+//
+// Writers take a mutex, so they run one at a time.  add() links a new
+// node in at the head of its bucket; when the array has to grow, a
+// complete new array (with new nodes) is built alongside the old one and
+// then published with a single atomic store.  remove() unlinks its node
+// the same way.  What's left over -- the old array and its nodes, or the
+// removed node -- may still be in use by readers that started before it
+// was unlinked, so it's "retired" rather than deleted: the writer waits,
+// using epochs, until every such reader has finished, and only then
+// deletes it.  So writers can be slow, but readers never wait for them.
+//
+// Readers announce themselves by counting themselves into one of
+// READER_SLOTS counters (chosen per thread), split by the parity of the
+// current epoch.  A writer that retires something advances the epoch,
+// which sends new readers to the other counter, and waits for the old
+// counter to drain in every slot; doing that twice guarantees that no
+// reader that might have seen the retired memory is still running.
+
+namespace impl_
+{
+    // RcuHashSet__readerIndex() returns a number identifying the calling
+    // thread, used to spread readers across the RcuHashSet's counters.
+    inline unsigned int RcuHashSet__readerIndex() noexcept
+    {
+        static std::atomic<unsigned int> nextIndex{0};
+        thread_local unsigned int index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+}
+
+
+
+template <typename ElementType, typename Hasher = HashSetFunctionHasher<ElementType>>
+class RcuHashSet : public Set<ElementType>
+{
+public:
+    // The number of buckets before anything has been added.  Bucket counts
+    // are always a power of two.
+    static constexpr unsigned int DEFAULT_CAPACITY = 16;
+
+    // The number of counters that readers are spread across.  Readers on
+    // different threads mostly use different counters, each on its own
+    // cache line, so they don't slow each other down.
+    static constexpr unsigned int READER_SLOTS = 64;
+
+public:
+    // Initializes an RcuHashSet to be empty, so that it will use the given
+    // hasher (see HashSet.hpp) whenever it needs to hash an element.  The
+    // hasher will be called from many threads at once, so it must be safe
+    // to call concurrently.
+    explicit RcuHashSet(Hasher hasher = Hasher());
+
+    // Cleans up the RcuHashSet so that it leaks no memory.  No other thread
+    // may be using it by then.
+    virtual ~RcuHashSet() noexcept;
+
+    // An RcuHashSet can be neither copied nor moved, since other threads
+    // may be using it while that happens.
+    RcuHashSet(const RcuHashSet& s) = delete;
+    RcuHashSet& operator=(const RcuHashSet& s) = delete;
+
+
+    // isImplemented() returns true, since an RcuHashSet is fully
+    // implemented.
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the set,
+    // this function has no effect.  It can run alongside any number of calls
+    // to contains(), but waits for other calls to add() and remove().  When
+    // the ratio of size to capacity would exceed 0.8, the array is copied
+    // into one twice the size, and this function then waits for the readers
+    // of the old one to finish before deleting it.
+    virtual void add(const ElementType& element) override;
+
+
+    // remove() removes an element from the set.  If the element isn't in
+    // the set, this function has no effect.  Like add(), it runs one at a
+    // time with other writers, and after unlinking the element's node, it
+    // waits for any readers that might still be looking at it.
+    void remove(const ElementType& element);
+
+
+    // contains() returns true if the given element is in the set, false
+    // otherwise.  It never takes a lock or waits for another thread, and
+    // runs in constant time (assuming a good hash function).
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.  If other threads
+    // are adding or removing elements at the same time, the result may
+    // already be out of date when it's returned.
+    virtual unsigned int size() const noexcept override;
+
+
+    // bucketCount() returns the number of buckets in the array.  Like
+    // contains(), it can be called while another thread adds or removes
+    // elements, though its answer may already be out of date.
+    unsigned int bucketCount() const noexcept;
+
+
+private:
+    // Everything but next is fixed before a node is published.
+    struct Node
+    {
+        ElementType element;
+        unsigned int hash;
+        std::atomic<Node*> next;
+
+        Node(const ElementType& newElement, unsigned int newHash, Node* newNext);
+    };
+
+    struct Table
+    {
+        unsigned int capacity;
+        std::unique_ptr<std::atomic<Node*>[]> buckets;
+
+        explicit Table(unsigned int newCapacity);
+    };
+
+    struct alignas(64) ReaderSlot
+    {
+        std::atomic<unsigned long> counts[2];
+    };
+
+    // A ReadSection counts a reader in for as long as it exists.
+    class ReadSection
+    {
+    public:
+        explicit ReadSection(const RcuHashSet& s) noexcept;
+        ~ReadSection() noexcept;
+
+    private:
+        std::atomic<unsigned long>& count;
+    };
+
+    Hasher hasher;
+    std::atomic<Table*> table;
+    std::atomic<unsigned int> sz;
+    std::atomic<unsigned int> epoch;
+    mutable ReaderSlot readers[READER_SLOTS];
+    std::mutex writeMutex;
+
+
+private:
+    static bool chainContains(
+        const Node* curr, const ElementType& element, unsigned int hash) noexcept;
+    Table* grow(const Table* current);
+    void synchronize() noexcept;
+    static void destroy(Table* retired) noexcept;
+};
+
+
+
+template <typename ElementType, typename Hasher>
+RcuHashSet<ElementType, Hasher>::Node::Node(
+    const ElementType& newElement, unsigned int newHash, Node* newNext)
+    : element(newElement), hash(newHash), next(newNext)
+{
+}
+
+
+template <typename ElementType, typename Hasher>
+RcuHashSet<ElementType, Hasher>::Table::Table(unsigned int newCapacity)
+    : capacity{newCapacity}, buckets{new std::atomic<Node*>[newCapacity]}
+{
+    for (unsigned int i = 0; i < capacity; ++i)
+    {
+        buckets[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+RcuHashSet<ElementType, Hasher>::ReadSection::ReadSection(const RcuHashSet& s) noexcept
+    : count{s.readers[impl_::RcuHashSet__readerIndex() % READER_SLOTS]
+                .counts[s.epoch.load(std::memory_order_relaxed) & 1]}
+{
+    // See contains() for why this is sequentially consistent.
+    count.fetch_add(1, std::memory_order_seq_cst);
+}
+
+
+template <typename ElementType, typename Hasher>
+RcuHashSet<ElementType, Hasher>::ReadSection::~ReadSection() noexcept
+{
+    count.fetch_sub(1, std::memory_order_release);
+}
+
+
+template <typename ElementType, typename Hasher>
+RcuHashSet<ElementType, Hasher>::RcuHashSet(Hasher hasher)
+    : hasher{hasher}, table{new Table{DEFAULT_CAPACITY}}, sz{0}, epoch{0}
+{
+    for (ReaderSlot& slot : readers)
+    {
+        slot.counts[0].store(0, std::memory_order_relaxed);
+        slot.counts[1].store(0, std::memory_order_relaxed);
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+RcuHashSet<ElementType, Hasher>::~RcuHashSet() noexcept
+{
+    destroy(table.load(std::memory_order_relaxed));
+}
+
+
+template <typename ElementType, typename Hasher>
+bool RcuHashSet<ElementType, Hasher>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType, typename Hasher>
+void RcuHashSet<ElementType, Hasher>::add(const ElementType& element)
+{
+    unsigned int hash = hasher(element);
+    std::lock_guard<std::mutex> lock{writeMutex};
+
+    // Only writers change the table pointer, and they hold the mutex, so
+    // it can be loaded without ordering here.
+    Table* current = table.load(std::memory_order_relaxed);
+
+    if (chainContains(
+            current->buckets[hash & (current->capacity - 1)].load(std::memory_order_relaxed),
+            element, hash))
+    {
+        return;
+    }
+
+    unsigned int oldSize = sz.load(std::memory_order_relaxed);
+
+    if (oldSize + 1 > current->capacity * 0.8)
+    {
+        current = grow(current);
+    }
+
+    // The node is complete before the release store makes it visible.
+    std::atomic<Node*>& head = current->buckets[hash & (current->capacity - 1)];
+    head.store(
+        new Node{element, hash, head.load(std::memory_order_relaxed)},
+        std::memory_order_release);
+
+    sz.store(oldSize + 1, std::memory_order_relaxed);
+}
+
+
+template <typename ElementType, typename Hasher>
+void RcuHashSet<ElementType, Hasher>::remove(const ElementType& element)
+{
+    unsigned int hash = hasher(element);
+    std::lock_guard<std::mutex> lock{writeMutex};
+
+    Table* current = table.load(std::memory_order_relaxed);
+    std::atomic<Node*>* link = &current->buckets[hash & (current->capacity - 1)];
+
+    for (Node* curr = link->load(std::memory_order_relaxed); curr != nullptr;
+         link = &curr->next, curr = link->load(std::memory_order_relaxed))
+    {
+        if (curr->hash == hash && curr->element == element)
+        {
+            // A reader already standing on the node can still follow its
+            // next pointer, which is left as it is.
+            link->store(curr->next.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+            sz.store(sz.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+
+            synchronize();
+            delete curr;
+            return;
+        }
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+bool RcuHashSet<ElementType, Hasher>::contains(const ElementType& element) const
+{
+    unsigned int hash = hasher(element);
+    ReadSection section{*this};
+
+    // The reader counting itself in, then loading pointers, mirrors a
+    // writer unlinking something, then reading the counts.  With all four
+    // sequentially consistent, either the writer sees the count (and waits)
+    // or the reader sees the unlinking (and never reaches what was retired).
+    // On x86, sequentially consistent loads cost no more than acquire loads.
+    const Table* current = table.load(std::memory_order_seq_cst);
+    return chainContains(
+        current->buckets[hash & (current->capacity - 1)].load(std::memory_order_seq_cst),
+        element, hash);
+}
+
+
+template <typename ElementType, typename Hasher>
+unsigned int RcuHashSet<ElementType, Hasher>::size() const noexcept
+{
+    return sz.load(std::memory_order_relaxed);
+}
+
+
+template <typename ElementType, typename Hasher>
+unsigned int RcuHashSet<ElementType, Hasher>::bucketCount() const noexcept
+{
+    // The table may be retired by a concurrent grow() as soon as it's
+    // loaded, so it's only safe to read from within a ReadSection.
+    ReadSection section{*this};
+    return table.load(std::memory_order_seq_cst)->capacity;
+}
+
+
+template <typename ElementType, typename Hasher>
+bool RcuHashSet<ElementType, Hasher>::chainContains(
+    const Node* curr, const ElementType& element, unsigned int hash) noexcept
+{
+    for (; curr != nullptr; curr = curr->next.load(std::memory_order_seq_cst))
+    {
+        if (curr->hash == hash && curr->element == element)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+// grow() publishes a copy of the given table with twice as many buckets,
+// then retires the old one, returning the new one.  Readers may be walking
+// the old chains the whole time, so the nodes are copied, not relinked.
+template <typename ElementType, typename Hasher>
+typename RcuHashSet<ElementType, Hasher>::Table* RcuHashSet<ElementType, Hasher>::grow(
+    const Table* current)
+{
+    std::unique_ptr<Table> bigger{new Table{current->capacity * 2}};
+    unsigned int mask = bigger->capacity - 1;
+
+    try
+    {
+        for (unsigned int i = 0; i < current->capacity; ++i)
+        {
+            for (Node* curr = current->buckets[i].load(std::memory_order_relaxed);
+                 curr != nullptr; curr = curr->next.load(std::memory_order_relaxed))
+            {
+                std::atomic<Node*>& head = bigger->buckets[curr->hash & mask];
+                head.store(
+                    new Node{curr->element, curr->hash, head.load(std::memory_order_relaxed)},
+                    std::memory_order_relaxed);
+            }
+        }
+    }
+    catch (...)
+    {
+        destroy(bigger.release());
+        throw;
+    }
+
+    Table* published = bigger.release();
+    table.store(published, std::memory_order_seq_cst);
+
+    synchronize();
+    destroy(const_cast<Table*>(current));
+
+    return published;
+}
+
+
+// synchronize() returns once every reader that was running when it was
+// called has finished.
+template <typename ElementType, typename Hasher>
+void RcuHashSet<ElementType, Hasher>::synchronize() noexcept
+{
+    // A reader may pick its counter just before the epoch advances, but
+    // count itself in just after the writer has found that counter empty;
+    // such a reader is ordered after the writer's unlinking, so it can't
+    // see what was retired (see contains()).  Draining both counters, one
+    // after the other, covers every reader that started earlier, while
+    // readers that start in the meantime use the other counter, so the
+    // wait always ends.
+    for (unsigned int phase = 0; phase < 2; ++phase)
+    {
+        unsigned int parity = epoch.fetch_add(1, std::memory_order_seq_cst) & 1;
+
+        for (ReaderSlot& slot : readers)
+        {
+            while (slot.counts[parity].load(std::memory_order_seq_cst) != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+
+template <typename ElementType, typename Hasher>
+void RcuHashSet<ElementType, Hasher>::destroy(Table* retired) noexcept
+{
+    for (unsigned int i = 0; i < retired->capacity; ++i)
+    {
+        Node* curr = retired->buckets[i].load(std::memory_order_relaxed);
+
+        while (curr != nullptr)
+        {
+            Node* next = curr->next.load(std::memory_order_relaxed);
+            delete curr;
+            curr = next;
+        }
+    }
+
+    delete retired;
+}
+
+
+
+#endif // RCUHASHSET_HPP
@@ -0,0 +1,419 @@
+#ifndef ROBINHOODHASHSET_HPP
+#define ROBINHOODHASHSET_HPP
+
+#include <functional>
+#include "Set.hpp"
+#include <algorithm>
+
+
+// A RobinHoodHashSet is an open-addressing alternative to HashSet.  Rather
+// than chaining each element through its own heap-allocated node, every
+// element is stored inline in one contiguous array of slots, and collisions
+// are resolved by linear probing with the "Robin Hood" rule: an element that
+// is further from its home index than the element already sitting in a slot
+// takes that slot over, and the displaced element moves on.  This keeps the
+// probe sequences short and roughly equal in length, so that a lookup is
+// usually a scan over a few neighbouring slots in the same cache line.
+//
+// ElementType must be default-constructible, since empty slots still hold
+// an (unused) element.
+
+template <typename ElementType>
+class RobinHoodHashSet : public Set<ElementType>
+{
+public:
+    // The default capacity of the RobinHoodHashSet before anything has
+    // been added to it.  Capacities are always powers of two, so that the
+    // home index of an element can be found with a mask instead of a
+    // division.
+    static constexpr unsigned int DEFAULT_CAPACITY = 16;
+
+    // A HashFunction is a function that takes a reference to a const
+    // ElementType and returns an unsigned int.
+    using HashFunction = std::function<unsigned int(const ElementType&)>;
+
+public:
+    // Initializes a RobinHoodHashSet to be empty, so that it will use the
+    // given hash function whenever it needs to hash an element.
+    explicit RobinHoodHashSet(HashFunction hashFunction);
+
+    // Cleans up the RobinHoodHashSet so that it leaks no memory.
+    virtual ~RobinHoodHashSet() noexcept;
+
+    // Initializes a new RobinHoodHashSet to be a copy of an existing one.
+    RobinHoodHashSet(const RobinHoodHashSet& s);
+
+    // Initializes a new RobinHoodHashSet whose contents are moved from an
+    // expiring one.
+    RobinHoodHashSet(RobinHoodHashSet&& s) noexcept;
+
+    // Assigns an existing RobinHoodHashSet into another.
+    RobinHoodHashSet& operator=(const RobinHoodHashSet& s);
+
+    // Assigns an expiring RobinHoodHashSet into another.
+    RobinHoodHashSet& operator=(RobinHoodHashSet&& s) noexcept;
+
+
+    // isImplemented() returns true, since a RobinHoodHashSet is fully
+    // implemented.
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the set,
+    // this function has no effect.  This function triggers a resizing of the
+    // array when the ratio of size to capacity would exceed 0.8.  In the case
+    // where the array is resized, this function runs in linear time (with
+    // respect to the number of elements, assuming a good hash function);
+    // otherwise, it runs in constant time (again, assuming a good hash
+    // function).
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  The probe stops as soon as it reaches a slot whose
+    // element is closer to its own home index than the element being
+    // searched for would be, so misses are as cheap as hits.
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // remove() removes an element from the set.  If the element is not in
+    // the set, this function has no effect.  Rather than leaving a
+    // "tombstone" behind, the elements following the removed one in its
+    // probe sequence are shifted back by one slot, so that lookups never
+    // have to step over deleted slots.
+    void remove(const ElementType& element);
+
+
+    // elementsAtIndex() returns the number of elements whose home index
+    // (i.e., the index they hashed to) is the given one, regardless of
+    // which slot they ended up in after probing.  If the index is out of
+    // the boundaries of the array, this function returns 0.
+    unsigned int elementsAtIndex(unsigned int index) const;
+
+
+    // isElementAtIndex() returns true if the given element is in the set
+    // and hashed to the given index, false otherwise.  If the index is out
+    // of the boundaries of the array, this function returns false.
+    bool isElementAtIndex(const ElementType& element, unsigned int index) const;
+
+
+private:
+    HashFunction hashFunction;
+
+    // Each slot stores its element inline, along with the element's full
+    // hash (so that resizing never calls the hash function again and
+    // most mismatches are rejected without comparing elements) and its
+    // distance from its home index.  A distance of 0 marks an empty slot;
+    // an element sitting in its home index has a distance of 1.
+    struct Slot
+    {
+        ElementType element;
+        unsigned int hash;
+        unsigned int distance;
+
+        Slot();
+    };
+
+    Slot* slots;
+    unsigned int sz;
+    unsigned int capacity;
+
+
+private:
+    unsigned int homeIndex(unsigned int hash) const noexcept;
+    int findSlot(const ElementType& element, unsigned int hash) const;
+    void insertSlot(ElementType element, unsigned int hash);
+    void resize(unsigned int newCapacity);
+    Slot* copySlots(const Slot* slots, unsigned int capacity);
+};
+
+
+
+template <typename ElementType>
+RobinHoodHashSet<ElementType>::Slot::Slot()
+    : element{}, hash{0}, distance{0}
+{
+}
+
+
+template <typename ElementType>
+RobinHoodHashSet<ElementType>::RobinHoodHashSet(HashFunction hashFunction)
+    : hashFunction{hashFunction}, slots{new Slot[DEFAULT_CAPACITY]},
+      sz{0}, capacity{DEFAULT_CAPACITY}
+{
+}
+
+
+template <typename ElementType>
+RobinHoodHashSet<ElementType>::~RobinHoodHashSet() noexcept
+{
+    delete[] slots;
+}
+
+
+template <typename ElementType>
+RobinHoodHashSet<ElementType>::RobinHoodHashSet(const RobinHoodHashSet& s)
+    : hashFunction{s.hashFunction}, slots{copySlots(s.slots, s.capacity)},
+      sz{s.sz}, capacity{s.capacity}
+{
+}
+
+
+template <typename ElementType>
+RobinHoodHashSet<ElementType>::RobinHoodHashSet(RobinHoodHashSet&& s) noexcept
+    : hashFunction{s.hashFunction}, slots{new Slot[DEFAULT_CAPACITY]},
+      sz{0}, capacity{DEFAULT_CAPACITY}
+{
+    std::swap(slots, s.slots);
+    std::swap(capacity, s.capacity);
+    std::swap(sz, s.sz);
+}
+
+
+template <typename ElementType>
+RobinHoodHashSet<ElementType>& RobinHoodHashSet<ElementType>::operator=(
+    const RobinHoodHashSet& s)
+{
+    if (this != &s)
+    {
+        Slot* newSlots = copySlots(s.slots, s.capacity);
+        delete[] slots;
+        slots = newSlots;
+        sz = s.sz;
+        capacity = s.capacity;
+        hashFunction = s.hashFunction;
+    }
+    return *this;
+}
+
+
+template <typename ElementType>
+RobinHoodHashSet<ElementType>& RobinHoodHashSet<ElementType>::operator=(
+    RobinHoodHashSet&& s) noexcept
+{
+    std::swap(slots, s.slots);
+    std::swap(capacity, s.capacity);
+    std::swap(sz, s.sz);
+    std::swap(hashFunction, s.hashFunction);
+    return *this;
+}
+
+
+template <typename ElementType>
+bool RobinHoodHashSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void RobinHoodHashSet<ElementType>::add(const ElementType& element)
+{
+    unsigned int hash = hashFunction(element);
+
+    if (findSlot(element, hash) != -1)
+    {
+        return;
+    }
+
+    if (sz + 1 > capacity * 0.8)
+    {
+        resize(capacity * 2);
+    }
+
+    insertSlot(element, hash);
+    ++sz;
+}
+
+
+template <typename ElementType>
+bool RobinHoodHashSet<ElementType>::contains(const ElementType& element) const
+{
+    return findSlot(element, hashFunction(element)) != -1;
+}
+
+
+template <typename ElementType>
+unsigned int RobinHoodHashSet<ElementType>::size() const noexcept
+{
+    return sz;
+}
+
+
+template <typename ElementType>
+void RobinHoodHashSet<ElementType>::remove(const ElementType& element)
+{
+    int found = findSlot(element, hashFunction(element));
+
+    if (found == -1)
+    {
+        return;
+    }
+
+    unsigned int mask = capacity - 1;
+    unsigned int hole = found;
+    unsigned int next = (hole + 1) & mask;
+
+    // Shift the rest of the cluster back by one slot, stopping at an empty
+    // slot or at an element that is already sitting in its home index.
+    while (slots[next].distance > 1)
+    {
+        slots[hole].element = std::move(slots[next].element);
+        slots[hole].hash = slots[next].hash;
+        slots[hole].distance = slots[next].distance - 1;
+        hole = next;
+        next = (next + 1) & mask;
+    }
+
+    slots[hole].element = ElementType{};
+    slots[hole].distance = 0;
+    --sz;
+}
+
+
+template <typename ElementType>
+unsigned int RobinHoodHashSet<ElementType>::elementsAtIndex(unsigned int index) const
+{
+    if (index >= capacity)
+    {
+        return 0;
+    }
+
+    // Elements whose home is this index all lie between it and the next
+    // empty slot (and there is always at least one empty slot, since the
+    // array is never allowed to fill up).
+    unsigned int count = 0;
+    unsigned int mask = capacity - 1;
+
+    for (unsigned int i = index; slots[i].distance != 0; i = (i + 1) & mask)
+    {
+        if (homeIndex(slots[i].hash) == index)
+        {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+
+template <typename ElementType>
+bool RobinHoodHashSet<ElementType>::isElementAtIndex(
+    const ElementType& element, unsigned int index) const
+{
+    if (index >= capacity)
+    {
+        return false;
+    }
+
+    unsigned int hash = hashFunction(element);
+    return homeIndex(hash) == index && findSlot(element, hash) != -1;
+}
+
+
+template <typename ElementType>
+unsigned int RobinHoodHashSet<ElementType>::homeIndex(unsigned int hash) const noexcept
+{
+    return hash & (capacity - 1);
+}
+
+
+template <typename ElementType>
+int RobinHoodHashSet<ElementType>::findSlot(
+    const ElementType& element, unsigned int hash) const
+{
+    unsigned int mask = capacity - 1;
+    unsigned int i = homeIndex(hash);
+
+    // Once we reach a slot whose element is closer to home than we would
+    // be, the element can't be any further along.
+    for (unsigned int distance = 1; slots[i].distance >= distance; ++distance)
+    {
+        if (slots[i].hash == hash && slots[i].element == element)
+        {
+            return i;
+        }
+
+        i = (i + 1) & mask;
+    }
+
+    return -1;
+}
+
+
+template <typename ElementType>
+void RobinHoodHashSet<ElementType>::insertSlot(ElementType element, unsigned int hash)
+{
+    unsigned int mask = capacity - 1;
+    unsigned int i = homeIndex(hash);
+    unsigned int distance = 1;
+
+    while (slots[i].distance != 0)
+    {
+        // Take from the rich (elements close to home) and give to the
+        // poor (the element we're carrying, which is further away).
+        if (slots[i].distance < distance)
+        {
+            std::swap(slots[i].element, element);
+            std::swap(slots[i].hash, hash);
+            std::swap(slots[i].distance, distance);
+        }
+
+        i = (i + 1) & mask;
+        ++distance;
+    }
+
+    slots[i].element = std::move(element);
+    slots[i].hash = hash;
+    slots[i].distance = distance;
+}
+
+
+template <typename ElementType>
+void RobinHoodHashSet<ElementType>::resize(unsigned int newCapacity)
+{
+    Slot* oldSlots = slots;
+    unsigned int oldCapacity = capacity;
+
+    slots = new Slot[newCapacity];
+    capacity = newCapacity;
+
+    for (unsigned int i = 0; i < oldCapacity; ++i)
+    {
+        if (oldSlots[i].distance != 0)
+        {
+            insertSlot(std::move(oldSlots[i].element), oldSlots[i].hash);
+        }
+    }
+
+    delete[] oldSlots;
+}
+
+
+template <typename ElementType>
+typename RobinHoodHashSet<ElementType>::Slot* RobinHoodHashSet<ElementType>::copySlots(
+    const Slot* slots, unsigned int capacity)
+{
+    Slot* newSlots = new Slot[capacity];
+
+    try
+    {
+        std::copy(slots, slots + capacity, newSlots);
+    }
+    catch (...)
+    {
+        delete[] newSlots;
+        throw;
+    }
+
+    return newSlots;
+}
+
+
+
+#endif // ROBINHOODHASHSET_HPP
+
@@ -184,6 +184,14 @@ public:
     virtual void add(const ElementType& element) override;
 
 
+    // remove() is a stub, like the rest of the SkipListSet until it's
+    // implemented (see isImplemented()): it has no effect.  Once it's
+    // implemented, it should unlink the element from every level it
+    // occupies, doing nothing if the element isn't in the set, in an
+    // expected time of O(log n).
+    void remove(const ElementType& element);
+
+
     // contains() returns true if the given element is already in the set,
     // false otherwise.  This function runs in an expected time of O(log n)
     // (i.e., over the long run, we expect the average to be O(log n))
@@ -279,6 +287,12 @@ void SkipListSet<ElementType>::add(const ElementType& element)
 }
 
 
+template <typename ElementType>
+void SkipListSet<ElementType>::remove(const ElementType& element)
+{
+}
+
+
 template <typename ElementType>
 bool SkipListSet<ElementType>::contains(const ElementType& element) const
 {
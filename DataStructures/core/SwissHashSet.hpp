@@ -0,0 +1,477 @@
+#ifndef SWISSHASHSET_HPP
+#define SWISSHASHSET_HPP
+
+#include <functional>
+#include "Set.hpp"
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+// A SwissHashSet is an open-addressing hash set in the style of the "Swiss
+// table."  Alongside the array of elements, it keeps a separate array of
+// one-byte control values, one per slot, that record whether the slot is
+// empty and, if not, seven bits of the element's hash (its "fingerprint").
+// Slots are arranged in groups of GROUP_WIDTH, and a lookup compares the
+// fingerprint against a whole group of control bytes at once (using SSE2
+// when it's available), so that elements are only ever compared when
+// their fingerprints match.  Most lookups examine a single group.
+//
+// ElementType must be default-constructible, since empty slots still hold
+// an (unused) element.
+
+template <typename ElementType>
+class SwissHashSet : public Set<ElementType>
+{
+public:
+    // The number of slots whose control bytes are examined together.
+    static constexpr unsigned int GROUP_WIDTH = 16;
+
+    // The default capacity of the SwissHashSet before anything has been
+    // added to it.  Capacities are always a power-of-two number of groups.
+    static constexpr unsigned int DEFAULT_CAPACITY = GROUP_WIDTH;
+
+    // A HashFunction is a function that takes a reference to a const
+    // ElementType and returns an unsigned int.
+    using HashFunction = std::function<unsigned int(const ElementType&)>;
+
+public:
+    // Initializes a SwissHashSet to be empty, so that it will use the
+    // given hash function whenever it needs to hash an element.
+    explicit SwissHashSet(HashFunction hashFunction);
+
+    // Cleans up the SwissHashSet so that it leaks no memory.
+    virtual ~SwissHashSet() noexcept;
+
+    // Initializes a new SwissHashSet to be a copy of an existing one.
+    SwissHashSet(const SwissHashSet& s);
+
+    // Initializes a new SwissHashSet whose contents are moved from an
+    // expiring one.
+    SwissHashSet(SwissHashSet&& s) noexcept;
+
+    // Assigns an existing SwissHashSet into another.
+    SwissHashSet& operator=(const SwissHashSet& s);
+
+    // Assigns an expiring SwissHashSet into another.
+    SwissHashSet& operator=(SwissHashSet&& s) noexcept;
+
+
+    // isImplemented() returns true, since a SwissHashSet is fully
+    // implemented.
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the set,
+    // this function has no effect.  This function triggers a resizing of the
+    // arrays when the ratio of size to capacity would exceed 15/16; since
+    // whole groups are probed at once, probe sequences stay short even at
+    // load factors that would cripple linear probing.  In the case where the
+    // arrays are resized, this function runs in linear time; otherwise, it
+    // runs in constant time (assuming a good hash function).
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in constant time (with respect
+    // to the number of elements, assuming a good hash function).
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // elementsAtIndex() returns the number of elements whose home group
+    // (i.e., the group their hash selected) is the given one, regardless of
+    // which group they ended up in after probing.  If the index is out of
+    // the boundaries of the array of groups, this function returns 0.
+    unsigned int elementsAtIndex(unsigned int index) const;
+
+
+    // isElementAtIndex() returns true if the given element is in the set
+    // and its hash selected the given group, false otherwise.  If the index
+    // is out of the boundaries of the array of groups, this function
+    // returns false.
+    bool isElementAtIndex(const ElementType& element, unsigned int index) const;
+
+
+private:
+    HashFunction hashFunction;
+
+    // A control byte is EMPTY when the slot is unused; otherwise, it is the
+    // low seven bits of the element's hash, so it never has its high bit set.
+    static constexpr signed char EMPTY = -128;
+
+    // Groups are aligned so that their control bytes can be loaded into a
+    // vector register with a single aligned load.
+    struct Group
+    {
+        alignas(GROUP_WIDTH) signed char ctrl[GROUP_WIDTH];
+
+        Group();
+
+        unsigned int match(signed char fingerprint) const noexcept;
+        unsigned int matchEmpty() const noexcept;
+    };
+
+    Group* groups;
+    ElementType* elements;
+    unsigned int* hashes;
+    unsigned int sz;
+    unsigned int capacity;
+
+
+private:
+    unsigned int groupCount() const noexcept;
+    unsigned int homeGroup(unsigned int hash) const noexcept;
+    int findSlot(const ElementType& element, unsigned int hash) const;
+    void insertSlot(ElementType element, unsigned int hash);
+    void allocate(unsigned int newCapacity);
+    void resize(unsigned int newCapacity);
+    void copyFrom(const SwissHashSet& s);
+};
+
+
+
+namespace impl_
+{
+    // Returns the index of the lowest set bit of a non-zero mask.
+    inline unsigned int SwissHashSet__lowestBit(unsigned int mask) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctz(mask);
+#else
+        unsigned int bit = 0;
+        while ((mask & 1) == 0)
+        {
+            mask >>= 1;
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+}
+
+
+template <typename ElementType>
+SwissHashSet<ElementType>::Group::Group()
+{
+    std::fill(ctrl, ctrl + GROUP_WIDTH, EMPTY);
+}
+
+
+template <typename ElementType>
+unsigned int SwissHashSet<ElementType>::Group::match(signed char fingerprint) const noexcept
+{
+#ifdef __SSE2__
+    __m128i bytes = _mm_load_si128(reinterpret_cast<const __m128i*>(ctrl));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(fingerprint)));
+#else
+    unsigned int mask = 0;
+    for (unsigned int i = 0; i < GROUP_WIDTH; ++i)
+    {
+        mask |= static_cast<unsigned int>(ctrl[i] == fingerprint) << i;
+    }
+    return mask;
+#endif
+}
+
+
+template <typename ElementType>
+unsigned int SwissHashSet<ElementType>::Group::matchEmpty() const noexcept
+{
+    return match(EMPTY);
+}
+
+
+template <typename ElementType>
+SwissHashSet<ElementType>::SwissHashSet(HashFunction hashFunction)
+    : hashFunction{hashFunction}, groups{nullptr}, elements{nullptr},
+      hashes{nullptr}, sz{0}, capacity{0}
+{
+    allocate(DEFAULT_CAPACITY);
+}
+
+
+template <typename ElementType>
+SwissHashSet<ElementType>::~SwissHashSet() noexcept
+{
+    delete[] groups;
+    delete[] elements;
+    delete[] hashes;
+}
+
+
+template <typename ElementType>
+SwissHashSet<ElementType>::SwissHashSet(const SwissHashSet& s)
+    : hashFunction{s.hashFunction}, groups{nullptr}, elements{nullptr},
+      hashes{nullptr}, sz{0}, capacity{0}
+{
+    copyFrom(s);
+}
+
+
+template <typename ElementType>
+SwissHashSet<ElementType>::SwissHashSet(SwissHashSet&& s) noexcept
+    : hashFunction{s.hashFunction}, groups{nullptr}, elements{nullptr},
+      hashes{nullptr}, sz{0}, capacity{0}
+{
+    allocate(DEFAULT_CAPACITY);
+    std::swap(groups, s.groups);
+    std::swap(elements, s.elements);
+    std::swap(hashes, s.hashes);
+    std::swap(sz, s.sz);
+    std::swap(capacity, s.capacity);
+}
+
+
+template <typename ElementType>
+SwissHashSet<ElementType>& SwissHashSet<ElementType>::operator=(const SwissHashSet& s)
+{
+    if (this != &s)
+    {
+        SwissHashSet copy{s};
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+
+template <typename ElementType>
+SwissHashSet<ElementType>& SwissHashSet<ElementType>::operator=(SwissHashSet&& s) noexcept
+{
+    std::swap(hashFunction, s.hashFunction);
+    std::swap(groups, s.groups);
+    std::swap(elements, s.elements);
+    std::swap(hashes, s.hashes);
+    std::swap(sz, s.sz);
+    std::swap(capacity, s.capacity);
+    return *this;
+}
+
+
+template <typename ElementType>
+bool SwissHashSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void SwissHashSet<ElementType>::add(const ElementType& element)
+{
+    unsigned int hash = hashFunction(element);
+
+    if (findSlot(element, hash) != -1)
+    {
+        return;
+    }
+
+    if (sz + 1 > capacity / 16 * 15)
+    {
+        resize(capacity * 2);
+    }
+
+    insertSlot(element, hash);
+    ++sz;
+}
+
+
+template <typename ElementType>
+bool SwissHashSet<ElementType>::contains(const ElementType& element) const
+{
+    return findSlot(element, hashFunction(element)) != -1;
+}
+
+
+template <typename ElementType>
+unsigned int SwissHashSet<ElementType>::size() const noexcept
+{
+    return sz;
+}
+
+
+template <typename ElementType>
+unsigned int SwissHashSet<ElementType>::elementsAtIndex(unsigned int index) const
+{
+    if (index >= groupCount())
+    {
+        return 0;
+    }
+
+    unsigned int count = 0;
+
+    for (unsigned int i = 0; i < capacity; ++i)
+    {
+        if (groups[i / GROUP_WIDTH].ctrl[i % GROUP_WIDTH] != EMPTY
+            && homeGroup(hashes[i]) == index)
+        {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+
+template <typename ElementType>
+bool SwissHashSet<ElementType>::isElementAtIndex(
+    const ElementType& element, unsigned int index) const
+{
+    if (index >= groupCount())
+    {
+        return false;
+    }
+
+    unsigned int hash = hashFunction(element);
+    return homeGroup(hash) == index && findSlot(element, hash) != -1;
+}
+
+
+template <typename ElementType>
+unsigned int SwissHashSet<ElementType>::groupCount() const noexcept
+{
+    return capacity / GROUP_WIDTH;
+}
+
+
+template <typename ElementType>
+unsigned int SwissHashSet<ElementType>::homeGroup(unsigned int hash) const noexcept
+{
+    // The low seven bits are the fingerprint, so the rest choose the group.
+    return (hash >> 7) & (groupCount() - 1);
+}
+
+
+template <typename ElementType>
+int SwissHashSet<ElementType>::findSlot(const ElementType& element, unsigned int hash) const
+{
+    signed char fingerprint = hash & 0x7F;
+    unsigned int mask = groupCount() - 1;
+    unsigned int g = homeGroup(hash);
+
+    // Groups are probed quadratically (g, g+1, g+3, g+6, ...), which visits
+    // every group exactly once when the number of groups is a power of two.
+    for (unsigned int step = 1; step <= groupCount(); ++step)
+    {
+        const Group& group = groups[g];
+
+        for (unsigned int matches = group.match(fingerprint); matches != 0;
+             matches &= matches - 1)
+        {
+            unsigned int i = g * GROUP_WIDTH + impl_::SwissHashSet__lowestBit(matches);
+
+            if (hashes[i] == hash && elements[i] == element)
+            {
+                return i;
+            }
+        }
+
+        // Elements are never removed, so an empty slot in this group means
+        // that no element's probe sequence ever continued past it.
+        if (group.matchEmpty() != 0)
+        {
+            return -1;
+        }
+
+        g = (g + step) & mask;
+    }
+
+    return -1;
+}
+
+
+template <typename ElementType>
+void SwissHashSet<ElementType>::insertSlot(ElementType element, unsigned int hash)
+{
+    unsigned int mask = groupCount() - 1;
+    unsigned int g = homeGroup(hash);
+
+    for (unsigned int step = 1; ; ++step)
+    {
+        unsigned int empties = groups[g].matchEmpty();
+
+        if (empties != 0)
+        {
+            unsigned int offset = impl_::SwissHashSet__lowestBit(empties);
+            unsigned int i = g * GROUP_WIDTH + offset;
+
+            groups[g].ctrl[offset] = hash & 0x7F;
+            elements[i] = std::move(element);
+            hashes[i] = hash;
+            return;
+        }
+
+        g = (g + step) & mask;
+    }
+}
+
+
+template <typename ElementType>
+void SwissHashSet<ElementType>::allocate(unsigned int newCapacity)
+{
+    Group* newGroups = new Group[newCapacity / GROUP_WIDTH];
+    ElementType* newElements = nullptr;
+    unsigned int* newHashes = nullptr;
+
+    try
+    {
+        newElements = new ElementType[newCapacity];
+        newHashes = new unsigned int[newCapacity];
+    }
+    catch (...)
+    {
+        delete[] newGroups;
+        delete[] newElements;
+        throw;
+    }
+
+    groups = newGroups;
+    elements = newElements;
+    hashes = newHashes;
+    capacity = newCapacity;
+}
+
+
+template <typename ElementType>
+void SwissHashSet<ElementType>::resize(unsigned int newCapacity)
+{
+    Group* oldGroups = groups;
+    ElementType* oldElements = elements;
+    unsigned int* oldHashes = hashes;
+    unsigned int oldCapacity = capacity;
+
+    allocate(newCapacity);
+
+    // The cached hashes mean that the hash function is never called again.
+    for (unsigned int i = 0; i < oldCapacity; ++i)
+    {
+        if (oldGroups[i / GROUP_WIDTH].ctrl[i % GROUP_WIDTH] != EMPTY)
+        {
+            insertSlot(std::move(oldElements[i]), oldHashes[i]);
+        }
+    }
+
+    delete[] oldGroups;
+    delete[] oldElements;
+    delete[] oldHashes;
+}
+
+
+template <typename ElementType>
+void SwissHashSet<ElementType>::copyFrom(const SwissHashSet& s)
+{
+    allocate(s.capacity);
+    std::copy(s.groups, s.groups + s.groupCount(), groups);
+    std::copy(s.elements, s.elements + s.capacity, elements);
+    std::copy(s.hashes, s.hashes + s.capacity, hashes);
+    sz = s.sz;
+}
+
+
+
+#endif // SWISSHASHSET_HPP
+
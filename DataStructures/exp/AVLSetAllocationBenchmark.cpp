@@ -0,0 +1,116 @@
+// AVLSetAllocationBenchmark.cpp
+//
+// Measures lookups in, and destruction of, large AVLSets whose nodes come
+// from a NodePool, taking its slabs either from the default memory
+// resource or from a std::pmr::monotonic_buffer_resource.  A std::set,
+// which allocates each node separately with new (as AVLSet used to), is
+// measured alongside for comparison.  Destroying an AVLSet<int> never
+// visits its nodes, since their destructors do nothing.
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <set>
+#include <string>
+#include "AVLSet.hpp"
+#include "Benchmark.hpp"
+
+
+namespace
+{
+    template <typename ElementType, typename MakeSet>
+    void measure(const char* name, const std::vector<ElementType>& elements, MakeSet makeSet)
+    {
+        // Each set is kept in a unique_ptr, so that the time it takes to
+        // destroy it can be measured on its own.
+        auto set = makeSet();
+        for (const ElementType& element : elements)
+        {
+            set->insert(element);
+        }
+
+        unsigned int found = 0;
+
+        double lookupTime = benchmark::timeSeconds([&]() {
+            for (const ElementType& element : elements)
+            {
+                found += set->count(element);
+            }
+        });
+
+        double teardownTime = benchmark::timeSeconds([&]() {
+            set.reset();
+        });
+
+        std::cout << "    " << std::left << std::setw(32) << name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(8) << lookupTime * 1e9 / elements.size() << " ns per lookup"
+                  << std::setw(8) << teardownTime * 1e3 << " ms teardown"
+                  << "   (" << found << " found)" << std::endl;
+    }
+
+
+    // SetAdapter gives an AVLSet the member function names of a std::set,
+    // so that both can be measured by the same code.  It also owns the
+    // arena, if there is one, which must outlive the set.
+    template <typename ElementType>
+    struct SetAdapter
+    {
+        std::unique_ptr<std::pmr::monotonic_buffer_resource> arena;
+        AVLSet<ElementType> set;
+
+        explicit SetAdapter(std::unique_ptr<std::pmr::monotonic_buffer_resource> newArena)
+            : arena{std::move(newArena)},
+              set{true, arena != nullptr ? arena.get() : std::pmr::get_default_resource()}
+        {
+        }
+
+        void insert(const ElementType& element)
+        {
+            set.add(element);
+        }
+
+        unsigned int count(const ElementType& element) const
+        {
+            return set.contains(element);
+        }
+    };
+
+
+    template <typename ElementType>
+    void measureAll(const char* description, const std::vector<ElementType>& elements)
+    {
+        std::cout << "  " << elements.size() << " " << description << std::endl;
+
+        measure("AVLSet, default resource", elements, []() {
+            return std::make_unique<SetAdapter<ElementType>>(nullptr);
+        });
+
+        measure("AVLSet, monotonic arena", elements, []() {
+            return std::make_unique<SetAdapter<ElementType>>(
+                std::make_unique<std::pmr::monotonic_buffer_resource>());
+        });
+
+        measure("std::set (a new per node)", elements, []() {
+            return std::make_unique<std::set<ElementType>>();
+        });
+    }
+}
+
+
+void runAVLSetAllocationBenchmark()
+{
+    std::cout << "AVLSet node allocation (lookups and teardown)" << std::endl;
+
+    std::vector<int> numbers(1000000);
+    std::mt19937 engine{50};
+    for (int& number : numbers)
+    {
+        number = static_cast<int>(engine());
+    }
+
+    measureAll("random ints", numbers);
+    measureAll("random words", benchmark::randomWords(1000000, 51));
+}
@@ -0,0 +1,102 @@
+// AVLSetSearchBenchmark.cpp
+//
+// Compares AVLSet::contains() on a million-word tree when each level takes
+// a single three-way comparison (std::string::compare(), which is what
+// AVLSetComparison<std::string> uses) against the generic comparison built
+// from operator<, which compares the strings a second time whenever the
+// first comparison fails.  The words are wrapped so that the comparisons
+// can be counted; the wrappers differ only in which comparison is used.
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "AVLSet.hpp"
+#include "Benchmark.hpp"
+
+
+namespace
+{
+    unsigned long long comparisons = 0;
+
+
+    // A Word<true> is searched with three-way comparisons, a Word<false>
+    // with operator< alone.
+    template <bool THREE_WAY>
+    struct Word
+    {
+        std::string text;
+    };
+
+
+    template <bool THREE_WAY>
+    bool operator<(const Word<THREE_WAY>& a, const Word<THREE_WAY>& b)
+    {
+        ++comparisons;
+        return a.text < b.text;
+    }
+
+}
+
+
+template <>
+struct AVLSetComparison<Word<true>>
+{
+    static int compare(const Word<true>& a, const Word<true>& b)
+    {
+        ++comparisons;
+        return a.text.compare(b.text);
+    }
+};
+
+
+namespace
+{
+    template <bool THREE_WAY>
+    void measure(const char* name, const std::vector<std::string>& words,
+                 const std::vector<std::string>& probes)
+    {
+        AVLSet<Word<THREE_WAY>> set;
+        for (const std::string& word : words)
+        {
+            set.add(Word<THREE_WAY>{word});
+        }
+
+        std::vector<Word<THREE_WAY>> keys;
+        for (const std::string& probe : probes)
+        {
+            keys.push_back(Word<THREE_WAY>{probe});
+        }
+
+        unsigned int found = 0;
+        comparisons = 0;
+
+        double time = benchmark::timeSeconds([&]() {
+            for (const Word<THREE_WAY>& key : keys)
+            {
+                found += set.contains(key);
+            }
+        });
+
+        std::cout << "    " << std::left << std::setw(22) << name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(8) << time * 1e9 / keys.size() << " ns per lookup"
+                  << std::setw(7) << static_cast<double>(comparisons) / keys.size()
+                  << " comparisons per lookup"
+                  << "   (" << found << " found, height " << set.height() << ")" << std::endl;
+    }
+}
+
+
+void runAVLSetSearchBenchmark()
+{
+    std::cout << "AVLSet lookups in a tree of 1000000 words" << std::endl;
+
+    // Half of the probes are words in the tree and half are not.
+    std::vector<std::string> words = benchmark::randomWords(1000000, 48);
+    std::vector<std::string> probes{words.begin(), words.begin() + 500000};
+    std::vector<std::string> misses = benchmark::randomWords(500000, 49);
+    probes.insert(probes.end(), misses.begin(), misses.end());
+
+    measure<true>("three-way comparison", words, probes);
+    measure<false>("operator< comparison", words, probes);
+}
@@ -0,0 +1,73 @@
+// BatchLookupBenchmark.cpp
+//
+// Compares looking up a batch of words in a HashSet with a loop of calls
+// to contains() against a single call to containsBatch(), which overlaps
+// the lookups' cache misses.  The dictionaries range from ones that fit
+// comfortably in the cache to ones far larger than the last-level cache,
+// which is where the difference shows.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include "Benchmark.hpp"
+#include "HashSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int LOOKUPS = 1000000;
+}
+
+
+void runBatchLookupBenchmark()
+{
+    std::cout << "HashSet::containsBatch() vs. contains() ("
+              << LOOKUPS << " lookups, half hits and half misses)" << std::endl;
+
+    for (unsigned int count : {10000u, 100000u, 1000000u, 4000000u})
+    {
+        std::vector<std::string> words = benchmark::randomWords(count, 46);
+
+        HashSet<std::string> set{benchmark::fnv1a};
+        for (const std::string& word : words)
+        {
+            set.add(word);
+        }
+
+        // The queries are spread randomly across the dictionary, so that
+        // consecutive lookups touch unrelated buckets.
+        std::vector<std::string> queries = benchmark::randomWords(LOOKUPS / 2, 47);
+        std::mt19937 engine{48};
+        std::uniform_int_distribution<unsigned int> pick{0, count - 1};
+        for (unsigned int i = 0; i < LOOKUPS / 2; ++i)
+        {
+            queries.push_back(words[pick(engine)]);
+        }
+        std::shuffle(queries.begin(), queries.end(), engine);
+
+        std::unique_ptr<bool[]> results{new bool[queries.size()]};
+        unsigned int loopFound = 0;
+        unsigned int batchFound = 0;
+
+        double loopTime = benchmark::timeSeconds([&]() {
+            for (const std::string& query : queries)
+            {
+                loopFound += set.contains(query);
+            }
+        });
+
+        double batchTime = benchmark::timeSeconds([&]() {
+            set.containsBatch(queries.data(), queries.size(), results.get());
+        });
+
+        batchFound = std::count(results.get(), results.get() + queries.size(), true);
+
+        std::cout << "  " << std::setw(8) << count << " words"
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(10) << loopTime * 1e9 / LOOKUPS << " ns/contains()"
+                  << std::setw(10) << batchTime * 1e9 / LOOKUPS << " ns/batched"
+                  << std::setw(8) << std::setprecision(2) << loopTime / batchTime << "x"
+                  << "   (" << loopFound << ", " << batchFound << " found)" << std::endl;
+    }
+}
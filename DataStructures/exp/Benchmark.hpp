@@ -0,0 +1,144 @@
+// Benchmark.hpp
+//
+// Small helpers shared by the benchmarks in the exp directory, along with
+// the declarations of the benchmarks themselves, so that expmain.cpp can
+// choose which of them to run.
+
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+
+
+namespace benchmark
+{
+    // Returns the number of seconds it takes to call f().
+    template <typename Function>
+    double timeSeconds(Function f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+
+    // Returns count distinct random words made up of the letters A-Z, with
+    // lengths between 3 and 12, generated deterministically from the seed.
+    inline std::vector<std::string> randomWords(unsigned int count, unsigned int seed)
+    {
+        std::mt19937 engine{seed};
+        std::uniform_int_distribution<int> length{3, 12};
+        std::uniform_int_distribution<int> letter{'A', 'Z'};
+
+        std::vector<std::string> words;
+        words.reserve(count);
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            std::string word(length(engine), ' ');
+            for (char& c : word)
+            {
+                c = static_cast<char>(letter(engine));
+            }
+
+            // Tagging each word with its index guarantees that they're
+            // all distinct, which keeps the element counts exact.
+            word += std::to_string(i);
+            words.push_back(word);
+        }
+
+        return words;
+    }
+
+
+    // A reasonable general-purpose string hash (FNV-1a), for benchmarks
+    // that need one.
+    inline unsigned int fnv1a(const std::string& s)
+    {
+        unsigned int hash = 2166136261u;
+        for (char c : s)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+}
+
+
+// Compares SwissHashSet against the chained HashSet for string lookups at
+// load factors from 0.5 to 0.9.
+void runSwissHashSetBenchmark();
+
+// Measures ConcurrentHashSet's add() and contains() throughput with 1 to 32
+// threads sharing one set.
+void runConcurrentHashSetBenchmark();
+
+// Compares word lookups in a HashSet whose hash function is a std::function
+// against ones whose hasher is known at compile time.
+void runHasherBenchmark();
+
+// Compares the bucket distribution and throughput of the hash functions in
+// Hashing.hpp against some alternatives.
+void runHashingBenchmark();
+
+// Compares word lookups in a FrozenHashSet against HashSet and SwissHashSet,
+// for dictionaries from ten thousand to a million words.
+void runFrozenHashSetBenchmark();
+
+// Compares HashSet::containsBatch() against a loop of contains() calls, for
+// dictionaries both smaller and much larger than the last-level cache.
+void runBatchLookupBenchmark();
+
+// Compares building a HashSet from a word list against opening a
+// MappedHashSet image of the same words.
+void runMappedHashSetBenchmark();
+
+// Compares the lookup latency distributions of CuckooHashSet and HashSet,
+// with both a good hash function and a skewed one.
+void runCuckooHashSetBenchmark();
+
+// Measures misspelling-heavy lookups in a HashSet with and without a Bloom
+// filter, at several filter sizes.
+void runBloomFilterBenchmark();
+
+// Compares loading a dictionary into a HashSet with add() alone, with
+// reserve() and add(), and with the range constructor.
+void runBulkLoadBenchmark();
+
+// Compares intersecting word sets with a loop of contains() calls against
+// setIntersection(), for HashSet and AVLSet.
+void runSetAlgebraBenchmark();
+
+// Compares the reader scaling of RcuHashSet and ConcurrentHashSet, with a
+// writer updating the set throughout.
+void runRcuHashSetBenchmark();
+
+// Compares word lookups in an InlineStringHashSet against a
+// HashSet<std::string>, for hits and misses separately.
+void runInlineStringHashSetBenchmark();
+
+// Measures copying a HashSet, which is copy-on-write, and the first add()
+// to the original once a copy shares its nodes.
+void runSnapshotBenchmark();
+
+// Compares AVLSet lookups using three-way comparisons against lookups
+// using operator<, counting the comparisons each makes.
+void runAVLSetSearchBenchmark();
+
+// Measures lookups in, and teardown of, large AVLSets whose nodes come
+// from a NodePool, alongside a std::set.
+void runAVLSetAllocationBenchmark();
+
+// Compares AVLSet's countInRange() and select() against inorder() scans.
+void runOrderStatisticBenchmark();
+
+
+
+#endif // BENCHMARK_HPP
+
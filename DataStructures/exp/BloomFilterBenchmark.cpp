@@ -0,0 +1,89 @@
+// BloomFilterBenchmark.cpp
+//
+// Measures the effect of HashSet's Bloom filter on the kind of lookups
+// that WordChecker::findSuggestions() makes: every single-letter edit of
+// a word, almost all of which are misspellings and therefore misses.  The
+// HashSet is measured without a filter and then with filters of several
+// sizes, reporting the time per lookup and the filter's false positive
+// rate, as counted by bloomFilterStats().
+
+#include <iomanip>
+#include <iostream>
+#include "Benchmark.hpp"
+#include "HashSet.hpp"
+
+
+namespace
+{
+    // Returns every word that differs from one of the given words by the
+    // replacement of a single letter.
+    std::vector<std::string> replacements(const std::vector<std::string>& words)
+    {
+        std::vector<std::string> edits;
+
+        for (const std::string& word : words)
+        {
+            for (std::size_t i = 0; i < word.size(); ++i)
+            {
+                std::string edit = word;
+                for (char c = 'A'; c <= 'Z'; ++c)
+                {
+                    edit[i] = c;
+                    edits.push_back(edit);
+                }
+            }
+        }
+
+        return edits;
+    }
+}
+
+
+void runBloomFilterBenchmark()
+{
+    for (unsigned int count : {100000u, 1000000u})
+    {
+        std::vector<std::string> words = benchmark::randomWords(count, 46);
+        std::vector<std::string> queries = replacements(
+            std::vector<std::string>(words.begin(), words.begin() + 20000));
+
+        HashSet<std::string, DefaultHasher<std::string>> set;
+        for (const std::string& word : words)
+        {
+            set.add(word);
+        }
+
+        std::cout << "HashSet Bloom filter (" << count << " words, " << queries.size()
+                  << " single-letter edits)" << std::endl;
+
+        for (unsigned int bitsPerKey : {0u, 6u, 10u, 16u})
+        {
+            if (bitsPerKey == 0)
+            {
+                set.disableBloomFilter();
+            }
+            else
+            {
+                set.enableBloomFilter(bitsPerKey);
+            }
+
+            unsigned int found = 0;
+            double time = benchmark::timeSeconds([&]() {
+                for (const std::string& query : queries)
+                {
+                    found += set.contains(query);
+                }
+            });
+
+            BloomFilterStats stats = set.bloomFilterStats();
+            double misses = static_cast<double>(queries.size() - found);
+
+            std::cout << "  " << std::setw(2) << bitsPerKey << " bits/key"
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(10) << time * 1e9 / queries.size() << " ns/lookup"
+                      << "   false positives " << std::setprecision(2) << std::setw(6)
+                      << (misses == 0 ? 0.0 : stats.falsePositives / misses * 100) << "%"
+                      << "   (" << found << " found)" << std::endl;
+        }
+    }
+}
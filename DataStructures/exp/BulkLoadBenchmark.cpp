@@ -0,0 +1,65 @@
+// BulkLoadBenchmark.cpp
+//
+// Compares three ways of loading a dictionary into a HashSet: a loop of
+// add() calls starting from the default capacity, which resizes the
+// array over and over as the set grows; the same loop after a call to
+// reserve(); and the range constructor, which sizes the array once,
+// hashes the words on several threads, and links them into their buckets
+// in a single pass.
+
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include "Benchmark.hpp"
+#include "HashSet.hpp"
+
+
+namespace
+{
+    using WordSet = HashSet<std::string, DefaultHasher<std::string>>;
+}
+
+
+void runBulkLoadBenchmark()
+{
+    std::cout << "HashSet bulk loading ("
+              << std::thread::hardware_concurrency() << " hardware threads)" << std::endl;
+
+    for (unsigned int count : {100000u, 500000u, 2000000u})
+    {
+        std::vector<std::string> words = benchmark::randomWords(count, 46);
+        unsigned int sizes = 0;
+
+        double addTime = benchmark::timeSeconds([&]() {
+            WordSet set;
+            for (const std::string& word : words)
+            {
+                set.add(word);
+            }
+            sizes += set.size();
+        });
+
+        double reserveTime = benchmark::timeSeconds([&]() {
+            WordSet set;
+            set.reserve(words.size());
+            for (const std::string& word : words)
+            {
+                set.add(word);
+            }
+            sizes += set.size();
+        });
+
+        double bulkTime = benchmark::timeSeconds([&]() {
+            WordSet set{words.begin(), words.end()};
+            sizes += set.size();
+        });
+
+        std::cout << "  " << std::setw(8) << count << " words"
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(9) << addTime * 1e3 << " ms add()"
+                  << std::setw(9) << reserveTime * 1e3 << " ms reserve()+add()"
+                  << std::setw(9) << bulkTime * 1e3 << " ms range constructor"
+                  << std::setw(7) << std::setprecision(2) << addTime / bulkTime << "x"
+                  << "   (" << sizes / 3 << " words each)" << std::endl;
+    }
+}
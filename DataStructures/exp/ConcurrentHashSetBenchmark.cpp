@@ -0,0 +1,90 @@
+// ConcurrentHashSetBenchmark.cpp
+//
+// Measures how the throughput of ConcurrentHashSet's add() and contains()
+// scales as the number of threads sharing one set grows from 1 to 32.
+// Each thread works on its own slice of the words, so the total amount of
+// work is the same no matter how many threads there are.
+
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include "Benchmark.hpp"
+#include "ConcurrentHashSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int WORD_COUNT = 1u << 18;
+    constexpr unsigned int LOOKUP_ROUNDS = 4;
+
+
+    // Runs work(first, last) on each of threadCount threads, giving each
+    // one an equal slice of [0, count).
+    template <typename Work>
+    void runThreads(unsigned int threadCount, unsigned int count, Work work)
+    {
+        std::vector<std::thread> threads;
+
+        for (unsigned int t = 0; t < threadCount; ++t)
+        {
+            unsigned int first = static_cast<unsigned long long>(count) * t / threadCount;
+            unsigned int last = static_cast<unsigned long long>(count) * (t + 1) / threadCount;
+            threads.emplace_back(work, first, last);
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+}
+
+
+void runConcurrentHashSetBenchmark()
+{
+    std::vector<std::string> words = benchmark::randomWords(WORD_COUNT, 46);
+
+    std::cout << "ConcurrentHashSet scaling (" << WORD_COUNT << " words, "
+              << std::thread::hardware_concurrency() << " hardware threads)"
+              << std::endl;
+
+    for (unsigned int threadCount : {1, 2, 4, 8, 16, 32})
+    {
+        ConcurrentHashSet<std::string> set{benchmark::fnv1a};
+
+        double addTime = benchmark::timeSeconds([&]() {
+            runThreads(threadCount, WORD_COUNT, [&](unsigned int first, unsigned int last) {
+                for (unsigned int i = first; i < last; ++i)
+                {
+                    set.add(words[i]);
+                }
+            });
+        });
+
+        std::atomic<unsigned int> found{0};
+
+        double containsTime = benchmark::timeSeconds([&]() {
+            runThreads(threadCount, WORD_COUNT, [&](unsigned int first, unsigned int last) {
+                unsigned int localFound = 0;
+
+                for (unsigned int round = 0; round < LOOKUP_ROUNDS; ++round)
+                {
+                    for (unsigned int i = first; i < last; ++i)
+                    {
+                        localFound += set.contains(words[i]);
+                    }
+                }
+
+                found += localFound;
+            });
+        });
+
+        std::cout << std::setw(4) << threadCount << " threads"
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(10) << WORD_COUNT / addTime / 1e6 << " M adds/s"
+                  << std::setw(10) << WORD_COUNT * LOOKUP_ROUNDS / containsTime / 1e6
+                  << " M lookups/s   (" << set.size() << " elements, "
+                  << found << " found)" << std::endl;
+    }
+}
+
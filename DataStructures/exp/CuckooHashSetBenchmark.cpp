@@ -0,0 +1,90 @@
+// CuckooHashSetBenchmark.cpp
+//
+// Compares the latency of individual lookups in the chained HashSet
+// against CuckooHashSet, both with a good hash function and with a badly
+// skewed one (the sum of a word's letters, which puts thousands of words
+// into the same few buckets).  Each lookup is timed separately, so that
+// the median, 99.9th percentile, and worst case can be reported; the
+// clock itself adds a few tens of nanoseconds to every measurement.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include "Benchmark.hpp"
+#include "CuckooHashSet.hpp"
+#include "HashSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int WORD_COUNT = 100000;
+
+
+    unsigned int letterSum(const std::string& s)
+    {
+        unsigned int sum = 0;
+        for (char c : s)
+        {
+            sum += static_cast<unsigned char>(c);
+        }
+        return sum;
+    }
+
+
+    template <typename SetType>
+    void measure(const char* name, SetType& set, const std::vector<std::string>& words)
+    {
+        for (const std::string& word : words)
+        {
+            set.add(word);
+        }
+
+        std::vector<std::string> queries = words;
+        std::shuffle(queries.begin(), queries.end(), std::mt19937{47});
+
+        std::vector<double> latencies;
+        latencies.reserve(queries.size());
+        unsigned int found = 0;
+
+        for (const std::string& query : queries)
+        {
+            latencies.push_back(benchmark::timeSeconds([&]() {
+                found += set.contains(query);
+            }));
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+
+        auto percentile = [&](double p) {
+            return latencies[static_cast<std::size_t>(p * (latencies.size() - 1))] * 1e9;
+        };
+
+        std::cout << "  " << std::left << std::setw(30) << name << std::right
+                  << std::fixed << std::setprecision(0)
+                  << "   median " << std::setw(7) << percentile(0.5) << " ns"
+                  << "   p99.9 " << std::setw(7) << percentile(0.999) << " ns"
+                  << "   max " << std::setw(8) << percentile(1.0) << " ns"
+                  << "   (" << found << " found)" << std::endl;
+    }
+}
+
+
+void runCuckooHashSetBenchmark()
+{
+    std::vector<std::string> words = benchmark::randomWords(WORD_COUNT, 46);
+
+    std::cout << "CuckooHashSet vs. HashSet lookup latency (" << WORD_COUNT << " words)"
+              << std::endl;
+
+    HashSet<std::string> goodHashSet{benchmark::fnv1a};
+    measure("HashSet (FNV-1a)", goodHashSet, words);
+
+    CuckooHashSet<std::string> goodCuckooHashSet{benchmark::fnv1a};
+    measure("CuckooHashSet (FNV-1a)", goodCuckooHashSet, words);
+
+    HashSet<std::string> skewedHashSet{letterSum};
+    measure("HashSet (letter sum)", skewedHashSet, words);
+
+    CuckooHashSet<std::string> skewedCuckooHashSet{letterSum};
+    measure("CuckooHashSet (letter sum)", skewedCuckooHashSet, words);
+}
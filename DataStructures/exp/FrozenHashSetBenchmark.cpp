@@ -0,0 +1,94 @@
+// FrozenHashSetBenchmark.cpp
+//
+// Compares word lookups in a FrozenHashSet, whose minimal perfect hash
+// function finds every element with a single probe, against the chained
+// HashSet and the SwissHashSet holding the same words, along with how long
+// the FrozenHashSet takes to build.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include "Benchmark.hpp"
+#include "FrozenHashSet.hpp"
+#include "HashSet.hpp"
+#include "SwissHashSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int LOOKUP_ROUNDS = 5;
+
+
+    template <typename SetType>
+    void measure(const char* name, const SetType& set, const std::vector<std::string>& words,
+                 const std::vector<std::string>& misses)
+    {
+        unsigned int found = 0;
+
+        double hitTime = benchmark::timeSeconds([&]() {
+            for (unsigned int round = 0; round < LOOKUP_ROUNDS; ++round)
+            {
+                for (const std::string& word : words)
+                {
+                    found += set.contains(word);
+                }
+            }
+        });
+
+        double missTime = benchmark::timeSeconds([&]() {
+            for (unsigned int round = 0; round < LOOKUP_ROUNDS; ++round)
+            {
+                for (const std::string& word : misses)
+                {
+                    found += set.contains(word);
+                }
+            }
+        });
+
+        double lookups = static_cast<double>(words.size()) * LOOKUP_ROUNDS;
+
+        std::cout << "  " << std::left << std::setw(14) << name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(10) << hitTime * 1e9 / lookups << " ns/hit"
+                  << std::setw(10) << missTime * 1e9 / lookups << " ns/miss"
+                  << "   (" << found << " found)" << std::endl;
+    }
+}
+
+
+void runFrozenHashSetBenchmark()
+{
+    for (unsigned int count : {10000u, 100000u, 1000000u})
+    {
+        std::vector<std::string> words = benchmark::randomWords(count, 46);
+        std::vector<std::string> misses = benchmark::randomWords(2 * count, 47);
+        misses.erase(misses.begin(), misses.begin() + count);
+
+        HashSet<std::string> hashSet{benchmark::fnv1a};
+        SwissHashSet<std::string> swissHashSet{benchmark::fnv1a};
+        for (const std::string& word : words)
+        {
+            hashSet.add(word);
+            swissHashSet.add(word);
+        }
+
+        FrozenHashSet<std::string>* frozen = nullptr;
+        double buildTime = benchmark::timeSeconds([&]() {
+            frozen = new FrozenHashSet<std::string>{words};
+        });
+
+        std::cout << "FrozenHashSet vs. HashSet (" << count << " words, built in "
+                  << std::fixed << std::setprecision(1) << buildTime * 1e9 / count
+                  << " ns/word, " << frozen->bucketCount() << " buckets)" << std::endl;
+
+        // Looking the words up in the order they were added would favour
+        // HashSet, whose nodes were allocated in that order.
+        std::shuffle(words.begin(), words.end(), std::mt19937{48});
+
+        measure("HashSet", hashSet, words, misses);
+        measure("SwissHashSet", swissHashSet, words, misses);
+        measure("FrozenHashSet", *frozen, words, misses);
+
+        delete frozen;
+    }
+}
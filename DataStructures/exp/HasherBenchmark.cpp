@@ -0,0 +1,81 @@
+// HasherBenchmark.cpp
+//
+// Compares the cost of looking words up in a HashSet<std::string> whose
+// hash function is stored in a std::function (the default) against one
+// whose hasher is a stateless function object known at compile time.  The
+// first two sets use exactly the same hash function (FNV-1a), so the
+// difference between them is the cost of the indirect call; the third
+// uses DefaultHasher.
+
+#include <iomanip>
+#include <iostream>
+#include "Benchmark.hpp"
+#include "HashSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int WORD_COUNT = 200000;
+    constexpr unsigned int LOOKUP_ROUNDS = 5;
+
+
+    struct Fnv1aHasher
+    {
+        unsigned int operator()(const std::string& s) const noexcept
+        {
+            return benchmark::fnv1a(s);
+        }
+    };
+
+
+    template <typename SetType>
+    void measure(const char* name, SetType& set, const std::vector<std::string>& words,
+                 const std::vector<std::string>& misses)
+    {
+        for (const std::string& word : words)
+        {
+            set.add(word);
+        }
+
+        unsigned int found = 0;
+
+        double time = benchmark::timeSeconds([&]() {
+            for (unsigned int round = 0; round < LOOKUP_ROUNDS; ++round)
+            {
+                for (unsigned int i = 0; i < words.size(); ++i)
+                {
+                    found += set.contains(words[i]);
+                    found += set.contains(misses[i]);
+                }
+            }
+        });
+
+        double lookups = 2.0 * words.size() * LOOKUP_ROUNDS;
+
+        std::cout << "  " << std::left << std::setw(34) << name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(8) << time * 1e9 / lookups << " ns/lookup"
+                  << "   (" << found << " found)" << std::endl;
+    }
+}
+
+
+void runHasherBenchmark()
+{
+    std::vector<std::string> words = benchmark::randomWords(WORD_COUNT, 46);
+    std::vector<std::string> misses = benchmark::randomWords(2 * WORD_COUNT, 47);
+    misses.erase(misses.begin(), misses.begin() + WORD_COUNT);
+
+    std::cout << "HashSet<std::string> hashers (" << WORD_COUNT << " words, "
+              << "half hits and half misses)" << std::endl;
+
+    HashSet<std::string> functionSet{benchmark::fnv1a};
+    measure("std::function (FNV-1a)", functionSet, words, misses);
+
+    HashSet<std::string, Fnv1aHasher> functorSet;
+    measure("compile-time hasher (FNV-1a)", functorSet, words, misses);
+
+    HashSet<std::string, DefaultHasher<std::string>> defaultSet;
+    measure("compile-time hasher (DefaultHasher)", defaultSet, words, misses);
+}
+
@@ -0,0 +1,176 @@
+// HashingBenchmark.cpp
+//
+// Compares the hash functions in Hashing.hpp against a few alternatives,
+// looking at two things:
+//
+// * How evenly they spread words (and strided integers) across a
+//   HashSet's buckets, as seen through elementsAtIndex().  With a good
+//   hash function, the fraction of empty buckets should be close to
+//   e^(-load factor), and the longest chain should be short.
+//
+// * How quickly they hash, in gigabytes per second, both for short words
+//   and for long strings.
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include "Benchmark.hpp"
+#include "Hashing.hpp"
+#include "HashSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int WORD_COUNT = 100000;
+
+
+    unsigned int letterSum(const std::string& s)
+    {
+        unsigned int sum = 0;
+        for (char c : s)
+        {
+            sum += static_cast<unsigned char>(c);
+        }
+        return sum;
+    }
+
+
+    unsigned int stdHash(const std::string& s)
+    {
+        return static_cast<unsigned int>(std::hash<std::string>{}(s));
+    }
+
+
+    unsigned int identity(const int& i)
+    {
+        return static_cast<unsigned int>(i);
+    }
+
+
+    unsigned int mixed(const int& i)
+    {
+        return hashing::hashInteger(static_cast<unsigned int>(i));
+    }
+
+
+    template <typename ElementType>
+    void reportDistribution(const char* name, const HashSet<ElementType>& set)
+    {
+        unsigned int buckets = set.bucketCount();
+        unsigned int empty = 0;
+        unsigned int longest = 0;
+        double sumOfSquares = 0.0;
+
+        for (unsigned int i = 0; i < buckets; ++i)
+        {
+            unsigned int length = set.elementsAtIndex(i);
+            empty += length == 0;
+            longest = std::max(longest, length);
+            sumOfSquares += static_cast<double>(length) * length;
+        }
+
+        double loadFactor = static_cast<double>(set.size()) / buckets;
+
+        // The expected number of elements compared by a successful lookup,
+        // relative to what a perfectly random hash function would give.
+        double probes = sumOfSquares / set.size() / 2.0 + 0.5;
+        double idealProbes = 1.0 + loadFactor / 2.0;
+
+        std::cout << "  " << std::left << std::setw(22) << name << std::right
+                  << std::fixed << std::setprecision(3)
+                  << "empty " << std::setw(6) << static_cast<double>(empty) / buckets
+                  << " (ideal " << std::exp(-loadFactor) << ")"
+                  << "   longest " << std::setw(5) << longest
+                  << "   probes/hit " << std::setprecision(2) << std::setw(7) << probes
+                  << " (ideal " << idealProbes << ")" << std::endl;
+    }
+
+
+    template <typename Function>
+    void reportThroughput(const char* name, const std::vector<std::string>& strings,
+                          Function hash)
+    {
+        std::size_t bytes = 0;
+        for (const std::string& s : strings)
+        {
+            bytes += s.size();
+        }
+
+        unsigned int rounds = static_cast<unsigned int>(200000000 / bytes) + 1;
+        unsigned int sink = 0;
+
+        double time = benchmark::timeSeconds([&]() {
+            for (unsigned int round = 0; round < rounds; ++round)
+            {
+                for (const std::string& s : strings)
+                {
+                    sink += hash(s);
+                }
+            }
+        });
+
+        std::cout << "  " << std::left << std::setw(22) << name << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(8)
+                  << bytes * static_cast<double>(rounds) / time / 1e9 << " GB/s"
+                  << std::setw(8) << std::setprecision(1)
+                  << time * 1e9 / (static_cast<double>(rounds) * strings.size())
+                  << " ns/hash   (" << sink % 10 << ")" << std::endl;
+    }
+}
+
+
+void runHashingBenchmark()
+{
+    std::vector<std::string> words = benchmark::randomWords(WORD_COUNT, 46);
+
+    std::cout << "Bucket distribution of " << WORD_COUNT << " words" << std::endl;
+
+    for (auto [name, hash] : {
+            std::pair<const char*, unsigned int (*)(const std::string&)>{"letter sum", letterSum},
+            {"FNV-1a", benchmark::fnv1a},
+            {"std::hash", stdHash},
+            {"hashing::hashString", [](const std::string& s) { return hashing::hashString(s); }}})
+    {
+        HashSet<std::string> set{hash};
+        for (const std::string& word : words)
+        {
+            set.add(word);
+        }
+        reportDistribution(name, set);
+    }
+
+    std::cout << "Bucket distribution of " << WORD_COUNT << " multiples of 1280" << std::endl;
+
+    for (auto [name, hash] : {
+            std::pair<const char*, unsigned int (*)(const int&)>{"identity", identity},
+            {"hashing::hashInteger", mixed}})
+    {
+        HashSet<int> set{hash};
+        for (unsigned int i = 0; i < WORD_COUNT; ++i)
+        {
+            set.add(i * 1280);
+        }
+        reportDistribution(name, set);
+    }
+
+    std::vector<std::string> longStrings = benchmark::randomWords(64, 48);
+    for (std::string& s : longStrings)
+    {
+        while (s.size() < 64 * 1024)
+        {
+            s += s;
+        }
+    }
+
+    for (auto [description, strings] : {
+            std::pair<const char*, const std::vector<std::string>*>{"words", &words},
+            {"64 KiB strings", &longStrings}})
+    {
+        std::cout << "Hashing throughput (" << description << ")" << std::endl;
+        reportThroughput("FNV-1a", *strings, benchmark::fnv1a);
+        reportThroughput("std::hash", *strings, stdHash);
+        reportThroughput("hashing::hashString", *strings,
+                         [](const std::string& s) { return hashing::hashString(s); });
+    }
+}
+
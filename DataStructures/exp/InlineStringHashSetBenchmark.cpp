@@ -0,0 +1,76 @@
+// InlineStringHashSetBenchmark.cpp
+//
+// Compares word lookups in an InlineStringHashSet, which keeps short words
+// in the slots of one flat table, against a HashSet<std::string>, whose
+// words are each in a node of their own.  Both use the same hash function,
+// so the difference is in how many cache lines a lookup touches.  Hits and
+// misses are timed separately, for dictionaries both smaller and much
+// larger than the last-level cache.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include "Benchmark.hpp"
+#include "HashSet.hpp"
+#include "InlineStringHashSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int LOOKUPS = 1000000;
+
+
+    template <typename SetType>
+    double lookupTime(const SetType& set, const std::vector<std::string>& queries,
+                      unsigned int& found)
+    {
+        return benchmark::timeSeconds([&]() {
+            for (const std::string& query : queries)
+            {
+                found += set.contains(query);
+            }
+        });
+    }
+}
+
+
+void runInlineStringHashSetBenchmark()
+{
+    std::cout << "InlineStringHashSet vs. HashSet<std::string> ("
+              << LOOKUPS << " hits and " << LOOKUPS << " misses)" << std::endl;
+
+    for (unsigned int count : {100000u, 1000000u, 4000000u})
+    {
+        std::vector<std::string> words = benchmark::randomWords(count, 46);
+
+        HashSet<std::string, DefaultHasher<std::string>> nodes{words.begin(), words.end()};
+        InlineStringHashSet inlined;
+        for (const std::string& word : words)
+        {
+            inlined.add(word);
+        }
+
+        std::mt19937 engine{47};
+        std::uniform_int_distribution<unsigned int> pick{0, count - 1};
+        std::vector<std::string> hits;
+        for (unsigned int i = 0; i < LOOKUPS; ++i)
+        {
+            hits.push_back(words[pick(engine)]);
+        }
+        std::vector<std::string> misses = benchmark::randomWords(LOOKUPS, 48);
+
+        unsigned int found = 0;
+        double nodeHitTime = lookupTime(nodes, hits, found);
+        double inlineHitTime = lookupTime(inlined, hits, found);
+        double nodeMissTime = lookupTime(nodes, misses, found);
+        double inlineMissTime = lookupTime(inlined, misses, found);
+
+        std::cout << "  " << std::setw(8) << count << " words"
+                  << std::fixed << std::setprecision(1)
+                  << "   hits:" << std::setw(7) << nodeHitTime * 1e9 / LOOKUPS << " ns nodes"
+                  << std::setw(7) << inlineHitTime * 1e9 / LOOKUPS << " ns inline"
+                  << "   misses:" << std::setw(7) << nodeMissTime * 1e9 / LOOKUPS << " ns nodes"
+                  << std::setw(7) << inlineMissTime * 1e9 / LOOKUPS << " ns inline"
+                  << "   (" << found << " found)" << std::endl;
+    }
+}
@@ -0,0 +1,82 @@
+// MappedHashSetBenchmark.cpp
+//
+// Compares the cost of starting up with a dictionary: building a HashSet
+// from a word list every time, against opening a MappedHashSet image that
+// was written once.  Lookups in both are measured too, since the image is
+// only useful if searching it is about as fast as searching the HashSet.
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include "Benchmark.hpp"
+#include "HashSet.hpp"
+#include "MappedHashSet.hpp"
+
+
+namespace
+{
+    template <typename SetType>
+    double lookupTime(const SetType& set, const std::vector<std::string>& queries,
+                      unsigned int& found)
+    {
+        return benchmark::timeSeconds([&]() {
+            for (const std::string& query : queries)
+            {
+                found += set.contains(query);
+            }
+        });
+    }
+}
+
+
+void runMappedHashSetBenchmark()
+{
+    const std::string path = "MappedHashSetBenchmark.img";
+
+    std::cout << "MappedHashSet image vs. building a HashSet" << std::endl;
+
+    for (unsigned int count : {100000u, 1000000u})
+    {
+        std::vector<std::string> words = benchmark::randomWords(count, 46);
+        std::vector<std::string> queries = words;
+        std::shuffle(queries.begin(), queries.end(), std::mt19937{47});
+
+        HashSet<std::string, DefaultHasher<std::string>>* built = nullptr;
+        double buildTime = benchmark::timeSeconds([&]() {
+            built = new HashSet<std::string, DefaultHasher<std::string>>;
+            for (const std::string& word : words)
+            {
+                built->add(word);
+            }
+        });
+
+        double writeTime = benchmark::timeSeconds([&]() {
+            MappedHashSet::writeImage(words, path);
+        });
+
+        MappedHashSet* mapped = nullptr;
+        double openTime = benchmark::timeSeconds([&]() {
+            mapped = new MappedHashSet{path};
+        });
+
+        unsigned int found = 0;
+        double builtLookups = lookupTime(*built, queries, found);
+        double mappedLookups = lookupTime(*mapped, queries, found);
+
+        std::cout << "  " << std::setw(8) << count << " words" << std::fixed
+                  << std::setprecision(3)
+                  << "   build " << std::setw(8) << buildTime * 1e3 << " ms"
+                  << "   write image " << std::setw(8) << writeTime * 1e3 << " ms"
+                  << "   open image " << std::setw(6) << openTime * 1e3 << " ms"
+                  << std::setprecision(1)
+                  << "   HashSet " << std::setw(6) << builtLookups * 1e9 / count << " ns/hit"
+                  << "   image " << std::setw(6) << mappedLookups * 1e9 / count << " ns/hit"
+                  << "   (" << found << " found)" << std::endl;
+
+        delete mapped;
+        delete built;
+    }
+
+    std::remove(path.c_str());
+}
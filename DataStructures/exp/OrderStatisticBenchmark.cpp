@@ -0,0 +1,61 @@
+// OrderStatisticBenchmark.cpp
+//
+// Compares answering "how many words sort between these two?" and "which
+// word is k-th?" on a million-word AVLSet with countInRange() and
+// select(), which each walk down one path of the tree, against the
+// inorder() scans they replace.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "AVLSet.hpp"
+#include "Benchmark.hpp"
+
+
+void runOrderStatisticBenchmark()
+{
+    std::cout << "AVLSet order statistics on 1000000 words" << std::endl;
+
+    std::vector<std::string> words = benchmark::randomWords(1000000, 52);
+    AVLSet<std::string> set;
+    for (const std::string& word : words)
+    {
+        set.add(word);
+    }
+
+    constexpr unsigned int QUERIES = 20;
+    unsigned long long treeTotal = 0;
+    unsigned long long scanTotal = 0;
+
+    double treeTime = benchmark::timeSeconds([&]() {
+        for (unsigned int i = 0; i < QUERIES; ++i)
+        {
+            const std::string& lo = words[i * 2];
+            const std::string& hi = words[i * 2 + 1];
+            treeTotal += set.countInRange(std::min(lo, hi), std::max(lo, hi));
+            treeTotal += set.select(i * 40000).size();
+        }
+    });
+
+    double scanTime = benchmark::timeSeconds([&]() {
+        for (unsigned int i = 0; i < QUERIES; ++i)
+        {
+            const std::string& lo = std::min(words[i * 2], words[i * 2 + 1]);
+            const std::string& hi = std::max(words[i * 2], words[i * 2 + 1]);
+            unsigned int position = 0;
+
+            set.inorder([&](const std::string& word) {
+                scanTotal += lo <= word && word <= hi;
+                scanTotal += position++ == i * 40000 ? word.size() : 0;
+            });
+        }
+    });
+
+    std::cout << "    " << std::fixed << std::setprecision(2)
+              << std::setw(10) << treeTime * 1e6 / QUERIES << " us per query with countInRange() and select()"
+              << std::endl
+              << "    " << std::setw(10) << scanTime * 1e6 / QUERIES << " us per query with an inorder() scan"
+              << "   (" << (treeTotal == scanTotal ? "same answers" : "DIFFERENT ANSWERS") << ")"
+              << std::endl;
+}
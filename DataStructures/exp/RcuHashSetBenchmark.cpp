@@ -0,0 +1,110 @@
+// RcuHashSetBenchmark.cpp
+//
+// Measures how contains() throughput scales with the number of reader
+// threads, for an RcuHashSet (whose readers take no locks) against a
+// ConcurrentHashSet (whose readers take a shared lock on one shard).
+// Throughout each run, a writer thread keeps adding and removing a word
+// every millisecond, which is far more often than the dictionaries this
+// is meant for are updated.
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include "Benchmark.hpp"
+#include "ConcurrentHashSet.hpp"
+#include "RcuHashSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int WORD_COUNT = 1u << 18;
+    constexpr unsigned int LOOKUPS = 1u << 23;
+
+
+    // Returns the number of seconds it takes threadCount readers to look
+    // up LOOKUPS words between them in the given set, while a writer
+    // updates it.
+    template <typename SetType>
+    double readTime(SetType& set, const std::vector<std::string>& words,
+                    const std::vector<std::string>& updates, unsigned int threadCount,
+                    unsigned int& found)
+    {
+        std::atomic<bool> done{false};
+        std::atomic<unsigned int> totalFound{0};
+
+        std::thread writer{[&]() {
+            for (unsigned int i = 0; !done.load(std::memory_order_relaxed); ++i)
+            {
+                const std::string& word = updates[i % updates.size()];
+                set.add(word);
+                set.remove(word);
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+        }};
+
+        double time = benchmark::timeSeconds([&]() {
+            std::vector<std::thread> readers;
+
+            for (unsigned int t = 0; t < threadCount; ++t)
+            {
+                readers.emplace_back([&, t]() {
+                    unsigned int localFound = 0;
+
+                    for (unsigned int i = t; i < LOOKUPS; i += threadCount)
+                    {
+                        localFound += set.contains(words[i % WORD_COUNT]);
+                    }
+
+                    totalFound += localFound;
+                });
+            }
+
+            for (std::thread& reader : readers)
+            {
+                reader.join();
+            }
+        });
+
+        done.store(true);
+        writer.join();
+        found = totalFound;
+        return time;
+    }
+}
+
+
+void runRcuHashSetBenchmark()
+{
+    std::vector<std::string> words = benchmark::randomWords(WORD_COUNT, 46);
+    std::vector<std::string> updates = benchmark::randomWords(1000, 47);
+
+    std::cout << "RcuHashSet vs. ConcurrentHashSet reader scaling (" << WORD_COUNT
+              << " words, " << std::thread::hardware_concurrency() << " hardware threads)"
+              << std::endl;
+
+    RcuHashSet<std::string, DefaultHasher<std::string>> rcu;
+    ConcurrentHashSet<std::string> sharded{DefaultHasher<std::string>{}};
+
+    for (const std::string& word : words)
+    {
+        rcu.add(word);
+        sharded.add(word);
+    }
+
+    for (unsigned int threadCount : {1, 2, 4, 8, 16, 32})
+    {
+        unsigned int rcuFound = 0;
+        unsigned int shardedFound = 0;
+        double rcuTime = readTime(rcu, words, updates, threadCount, rcuFound);
+        double shardedTime = readTime(sharded, words, updates, threadCount, shardedFound);
+
+        std::cout << std::setw(4) << threadCount << " readers"
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(9) << LOOKUPS / rcuTime / 1e6 << " M lookups/s RCU"
+                  << std::setw(9) << LOOKUPS / shardedTime / 1e6 << " M lookups/s sharded"
+                  << std::setw(7) << shardedTime / rcuTime << "x"
+                  << "   (" << rcuFound << ", " << shardedFound << " found)" << std::endl;
+    }
+}
@@ -0,0 +1,113 @@
+// SetAlgebraBenchmark.cpp
+//
+// Compares intersecting a domain dictionary with a much larger base
+// lexicon by looping over one and calling contains() on the other against
+// setIntersection(), for both HashSet and AVLSet.  HashSet's version
+// looks the elements up in batches (on several threads when there are
+// enough of them); AVLSet's merges the two trees in sorted order.
+
+#include <iomanip>
+#include <iostream>
+#include <utility>
+#include "AVLSet.hpp"
+#include "Benchmark.hpp"
+#include "HashSet.hpp"
+
+
+namespace
+{
+    using WordSet = HashSet<std::string, DefaultHasher<std::string>>;
+
+
+    void report(const char* name, unsigned int elements, double loopTime, double algebraTime,
+                unsigned int loopSize, unsigned int algebraSize)
+    {
+        std::cout << "    " << std::left << std::setw(8) << name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(8) << elements / loopTime / 1e6 << " M/s contains() loop"
+                  << std::setw(8) << elements / algebraTime / 1e6 << " M/s setIntersection()"
+                  << std::setw(7) << std::setprecision(2) << loopTime / algebraTime << "x"
+                  << "   (" << loopSize << ", " << algebraSize << " common)" << std::endl;
+    }
+}
+
+
+void runSetAlgebraBenchmark()
+{
+    std::cout << "Set intersection throughput (elements of both sets per second)" << std::endl;
+
+    // The domain dictionaries range from much smaller than the lexicon,
+    // where searching one set for each element of the other is cheap, to
+    // as large as it, where merging pays off.
+    for (auto [lexiconSize, domainSize] : {std::pair{100000u, 20000u}, std::pair{500000u, 10000u},
+                                           std::pair{500000u, 100000u}, std::pair{500000u, 500000u},
+                                           std::pair{2000000u, 400000u}})
+    {
+        // Half of the domain words are also in the lexicon.
+        std::vector<std::string> lexicon = benchmark::randomWords(lexiconSize, 46);
+        std::vector<std::string> domain = benchmark::randomWords(domainSize / 2, 47);
+        domain.insert(domain.end(), lexicon.begin(), lexicon.begin() + domainSize / 2);
+
+        unsigned int elements = lexiconSize + domainSize;
+        std::cout << "  " << lexiconSize << "-word lexicon, "
+                  << domainSize << "-word domain dictionary" << std::endl;
+
+        {
+            WordSet lexiconSet{lexicon.begin(), lexicon.end()};
+            WordSet domainSet{domain.begin(), domain.end()};
+            unsigned int loopSize = 0;
+            unsigned int algebraSize = 0;
+
+            double loopTime = benchmark::timeSeconds([&]() {
+                WordSet common;
+                for (const std::string& word : domainSet.elements())
+                {
+                    if (lexiconSet.contains(word))
+                    {
+                        common.add(word);
+                    }
+                }
+                loopSize = common.size();
+            });
+
+            double algebraTime = benchmark::timeSeconds([&]() {
+                algebraSize = domainSet.setIntersection(lexiconSet).size();
+            });
+
+            report("HashSet", elements, loopTime, algebraTime, loopSize, algebraSize);
+        }
+
+        {
+            AVLSet<std::string> lexiconSet;
+            AVLSet<std::string> domainSet;
+            for (const std::string& word : lexicon)
+            {
+                lexiconSet.add(word);
+            }
+            for (const std::string& word : domain)
+            {
+                domainSet.add(word);
+            }
+
+            unsigned int loopSize = 0;
+            unsigned int algebraSize = 0;
+
+            double loopTime = benchmark::timeSeconds([&]() {
+                AVLSet<std::string> common;
+                domainSet.inorder([&](const std::string& word) {
+                    if (lexiconSet.contains(word))
+                    {
+                        common.add(word);
+                    }
+                });
+                loopSize = common.size();
+            });
+
+            double algebraTime = benchmark::timeSeconds([&]() {
+                algebraSize = domainSet.setIntersection(lexiconSet).size();
+            });
+
+            report("AVLSet", elements, loopTime, algebraTime, loopSize, algebraSize);
+        }
+    }
+}
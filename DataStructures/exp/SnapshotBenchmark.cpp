@@ -0,0 +1,52 @@
+// SnapshotBenchmark.cpp
+//
+// Measures what it costs to take a snapshot of a dictionary held in a
+// HashSet, as a request handler does: copying the set, searching the copy,
+// and then (in the worst case) adding a word to the original, which makes
+// the original copy its nodes, since the snapshot still shares them.
+
+#include <iomanip>
+#include <iostream>
+#include "Benchmark.hpp"
+#include "HashSet.hpp"
+
+
+namespace
+{
+    using WordSet = HashSet<std::string, DefaultHasher<std::string>>;
+}
+
+
+void runSnapshotBenchmark()
+{
+    std::cout << "HashSet snapshots (copy-on-write)" << std::endl;
+
+    for (unsigned int count : {10000u, 100000u, 1000000u})
+    {
+        std::vector<std::string> words = benchmark::randomWords(count, 47);
+        WordSet dictionary{words.begin(), words.end()};
+        constexpr unsigned int SNAPSHOTS = 1000;
+        unsigned int found = 0;
+
+        double snapshotTime = benchmark::timeSeconds([&]() {
+            for (unsigned int i = 0; i < SNAPSHOTS; ++i)
+            {
+                WordSet snapshot{dictionary};
+                found += snapshot.contains(words[i % words.size()]);
+            }
+        });
+
+        double detachTime = benchmark::timeSeconds([&]() {
+            WordSet snapshot{dictionary};
+            dictionary.add("snapshot");
+            found += snapshot.contains("snapshot");
+        });
+
+        std::cout << "  " << std::setw(8) << count << " words"
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(10) << snapshotTime * 1e6 / SNAPSHOTS << " us per snapshot"
+                  << std::setprecision(1)
+                  << std::setw(9) << detachTime * 1e3 << " ms first add() after one"
+                  << "   (" << found << " found)" << std::endl;
+    }
+}
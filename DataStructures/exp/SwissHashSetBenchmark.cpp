@@ -0,0 +1,89 @@
+// SwissHashSetBenchmark.cpp
+//
+// Compares lookups in the chained HashSet against lookups in SwissHashSet,
+// for both hits and misses, at several load factors.  The load factor is
+// measured against SwissHashSet's capacity of 2^17 slots, which it keeps
+// for every element count used here; the chained HashSet is given the same
+// elements and resizes however it normally would.
+
+#include <iomanip>
+#include <iostream>
+#include "Benchmark.hpp"
+#include "HashSet.hpp"
+#include "SwissHashSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int SLOTS = 1u << 17;
+    constexpr unsigned int LOOKUP_ROUNDS = 5;
+
+
+    template <typename SetType>
+    void measure(const char* name, const std::vector<std::string>& words,
+                 const std::vector<std::string>& misses)
+    {
+        SetType set{benchmark::fnv1a};
+
+        double addTime = benchmark::timeSeconds([&]() {
+            for (const std::string& word : words)
+            {
+                set.add(word);
+            }
+        });
+
+        unsigned int found = 0;
+
+        double hitTime = benchmark::timeSeconds([&]() {
+            for (unsigned int round = 0; round < LOOKUP_ROUNDS; ++round)
+            {
+                for (const std::string& word : words)
+                {
+                    found += set.contains(word);
+                }
+            }
+        });
+
+        double missTime = benchmark::timeSeconds([&]() {
+            for (unsigned int round = 0; round < LOOKUP_ROUNDS; ++round)
+            {
+                for (const std::string& word : misses)
+                {
+                    found += set.contains(word);
+                }
+            }
+        });
+
+        double lookups = static_cast<double>(words.size()) * LOOKUP_ROUNDS;
+
+        std::cout << "  " << std::left << std::setw(14) << name << std::right
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(10) << addTime * 1e9 / words.size() << " ns/add"
+                  << std::setw(10) << hitTime * 1e9 / lookups << " ns/hit"
+                  << std::setw(10) << missTime * 1e9 / lookups << " ns/miss"
+                  << "   (" << found << " found)" << std::endl;
+    }
+}
+
+
+void runSwissHashSetBenchmark()
+{
+    std::cout << "SwissHashSet vs. HashSet (" << SLOTS << " slots)" << std::endl;
+
+    for (double loadFactor : {0.5, 0.6, 0.7, 0.8, 0.9})
+    {
+        unsigned int count = static_cast<unsigned int>(SLOTS * loadFactor);
+
+        // The misses have the same shape as the hits but a different seed,
+        // and their index tags are out of the range of the hits' tags.
+        std::vector<std::string> words = benchmark::randomWords(count, 46);
+        std::vector<std::string> misses = benchmark::randomWords(2 * count, 47);
+        misses.erase(misses.begin(), misses.begin() + count);
+
+        std::cout << "load factor " << loadFactor << " (" << count << " words)"
+                  << std::endl;
+        measure<HashSet<std::string>>("HashSet", words, misses);
+        measure<SwissHashSet<std::string>>("SwissHashSet", words, misses);
+    }
+}
+
@@ -1,19 +1,29 @@
+// expmain.cpp
+//
+// Runs the benchmarks declared in Benchmark.hpp.
+
+#include "Benchmark.hpp"
 
-#include <algorithm>
-#include <iostream>
-#include <string>
 
 int main()
 {
-	std::string name = "Min Sung Cha";
-
-	int sum= 0;
-	for (auto letter : name)
-	{
-		sum += int(letter);
-	}
-
-	std::cout << sum << std::endl;
+    runSwissHashSetBenchmark();
+    runConcurrentHashSetBenchmark();
+    runHasherBenchmark();
+    runHashingBenchmark();
+    runFrozenHashSetBenchmark();
+    runBatchLookupBenchmark();
+    runMappedHashSetBenchmark();
+    runCuckooHashSetBenchmark();
+    runBloomFilterBenchmark();
+    runBulkLoadBenchmark();
+    runSetAlgebraBenchmark();
+    runRcuHashSetBenchmark();
+    runInlineStringHashSetBenchmark();
+    runSnapshotBenchmark();
+    runAVLSetSearchBenchmark();
+    runAVLSetAllocationBenchmark();
+    runOrderStatisticBenchmark();
 
     return 0;
 }
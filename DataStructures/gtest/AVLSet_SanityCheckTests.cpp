@@ -1,9 +1,56 @@
+#include <algorithm>
+#include <memory_resource>
+#include <random>
+#include <set>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <gtest/gtest.h>
 #include "AVLSet.hpp"
 
 
+namespace
+{
+    // A CountedKey is an int whose three-way comparisons are counted.
+    struct CountedKey
+    {
+        int value;
+        static unsigned int comparisons;
+    };
+
+    unsigned int CountedKey::comparisons = 0;
+
+
+    // A ReversedKey has no operator< at all; its AVLSetComparison orders
+    // it backward.
+    struct ReversedKey
+    {
+        int value;
+    };
+}
+
+
+template <>
+struct AVLSetComparison<CountedKey>
+{
+    static int compare(const CountedKey& a, const CountedKey& b)
+    {
+        ++CountedKey::comparisons;
+        return a.value < b.value ? -1 : (a.value > b.value ? 1 : 0);
+    }
+};
+
+
+template <>
+struct AVLSetComparison<ReversedKey>
+{
+    static int compare(const ReversedKey& a, const ReversedKey& b)
+    {
+        return b.value < a.value ? -1 : (a.value < b.value ? 1 : 0);
+    }
+};
+
+
 TEST(AVLSet_SanityCheckTests, inheritFromSet)
 {
     AVLSet<int> s1;
@@ -142,6 +189,28 @@ TEST(AVLSet_SanityCheckTests, heightDependsOnBalancing)
 }
 
 
+TEST(AVLSet_SanityCheckTests, copiesAndMovesKeepSizeAndBalancing)
+{
+    AVLSet<int> notBalanced{false};
+    notBalanced.add(1);
+    notBalanced.add(2);
+
+    AVLSet<int> copied{notBalanced};
+    AVLSet<int> assigned;
+    assigned = notBalanced;
+    AVLSet<int> moveAssigned;
+    moveAssigned = AVLSet<int>{notBalanced};
+
+    for (AVLSet<int>* s : {&copied, &assigned, &moveAssigned})
+    {
+        EXPECT_EQ(2, s->size());
+        s->add(3);
+        EXPECT_EQ(3, s->size());
+        EXPECT_EQ(2, s->height());
+    }
+}
+
+
 TEST(AVLSet_SanityCheckTests, canProvideTraversals)
 {
     AVLSet<int> s{false};
@@ -176,3 +245,257 @@ TEST(AVLSet_SanityCheckTests, canProvideTraversals)
 }
 
 
+TEST(AVLSet_SanityCheckTests, removeKeepsTreeBalanced)
+{
+    AVLSet<int> s;
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+    }
+
+    // Removing every other element, including nodes with two children,
+    // leaves a tree of 500 elements, which must be balanced.
+    for (int i = 0; i < 1000; i += 2)
+    {
+        s.remove(i);
+    }
+    s.remove(2);
+
+    EXPECT_EQ(500, s.size());
+    EXPECT_LE(s.height(), 12);
+
+    int previous = -1;
+    s.inorder([&](const int& element) {
+        EXPECT_LT(previous, element);
+        previous = element;
+    });
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(i % 2 == 1, s.contains(i));
+    }
+
+    for (int i = 1; i < 1000; i += 2)
+    {
+        s.remove(i);
+    }
+
+    EXPECT_EQ(0, s.size());
+    EXPECT_EQ(-1, s.height());
+}
+
+
+
+
+TEST(AVLSet_SanityCheckTests, setAlgebraMergesInSortedOrder)
+{
+    AVLSet<int> evens;
+    AVLSet<int> threes;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        evens.add(i * 2);
+        threes.add(i * 3);
+    }
+
+    AVLSet<int> both = evens.setIntersection(threes);
+    AVLSet<int> either = evens.setUnion(threes);
+    AVLSet<int> onlyEvens = evens.setDifference(threes);
+
+    EXPECT_EQ(334, both.size());
+    EXPECT_EQ(1666, either.size());
+    EXPECT_EQ(666, onlyEvens.size());
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        bool isEven = i % 2 == 0 && i < 2000;
+        bool isThree = i % 3 == 0;
+        EXPECT_EQ(isEven && isThree, both.contains(i));
+        EXPECT_EQ(isEven || isThree, either.contains(i));
+        EXPECT_EQ(isEven && !isThree, onlyEvens.contains(i));
+    }
+
+    // The results are built perfectly balanced, and can be added to.
+    EXPECT_EQ(10, either.height());
+    either.add(-1);
+    EXPECT_TRUE(either.contains(-1));
+    EXPECT_EQ(0, AVLSet<int>{}.setUnion(AVLSet<int>{}).size());
+}
+
+
+TEST(AVLSet_SanityCheckTests, setAlgebraSearchesWhenOneSetIsMuchSmaller)
+{
+    AVLSet<int> evens;
+    AVLSet<int> few;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        evens.add(i * 2);
+    }
+
+    // Ten elements, alternately even and odd, so that searching the larger
+    // set for each of them is cheaper than merging the two.
+    for (int i = 0; i < 10; ++i)
+    {
+        few.add(i * 1001);
+    }
+
+    AVLSet<int> both = evens.setIntersection(few);
+    AVLSet<int> bothReversed = few.setIntersection(evens);
+    AVLSet<int> onlyFew = few.setDifference(evens);
+
+    EXPECT_EQ(5, both.size());
+    EXPECT_EQ(5, bothReversed.size());
+    EXPECT_EQ(5, onlyFew.size());
+
+    for (int i = 0; i < 10; ++i)
+    {
+        bool isEven = i % 2 == 0;
+        EXPECT_EQ(isEven, both.contains(i * 1001));
+        EXPECT_EQ(isEven, bothReversed.contains(i * 1001));
+        EXPECT_EQ(!isEven, onlyFew.contains(i * 1001));
+    }
+
+    EXPECT_FALSE(both.contains(2));
+    EXPECT_EQ(0, AVLSet<int>{}.setDifference(evens).size());
+    EXPECT_EQ(0, AVLSet<int>{}.setIntersection(evens).size());
+}
+
+
+TEST(AVLSet_SanityCheckTests, containsComparesOncePerLevel)
+{
+    AVLSet<CountedKey> s;
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(CountedKey{i * 2});
+    }
+
+    for (int i = -1; i < 2001; ++i)
+    {
+        CountedKey::comparisons = 0;
+        EXPECT_EQ(i >= 0 && i < 2000 && i % 2 == 0, s.contains(CountedKey{i}));
+        EXPECT_LE(CountedKey::comparisons, s.height() + 1);
+    }
+
+    AVLSet<std::string> words;
+    words.add("bravo");
+    words.add("alpha");
+    words.add("charlie");
+    EXPECT_TRUE(words.contains("alpha"));
+    EXPECT_TRUE(words.contains("charlie"));
+    EXPECT_FALSE(words.contains("alph"));
+    EXPECT_FALSE(words.contains("delta"));
+}
+
+
+TEST(AVLSet_SanityCheckTests, canAllocateNodesFromMemoryResource)
+{
+    std::pmr::monotonic_buffer_resource arena;
+    AVLSet<std::string> s1{true, &arena};
+    for (int i = 0; i < 100; ++i)
+    {
+        s1.add(std::to_string(i));
+    }
+    s1.remove("50");
+
+    AVLSet<std::string> s2{s1};
+    AVLSet<std::string> s3{std::move(s1)};
+    AVLSet<std::string> s4;
+    s4 = std::move(s3);
+
+    EXPECT_TRUE(s4.contains("0"));
+    EXPECT_TRUE(s4.contains("99"));
+    EXPECT_FALSE(s4.contains("50"));
+    EXPECT_EQ(99, s4.size());
+    EXPECT_EQ(99, s2.size());
+}
+
+
+TEST(AVLSet_SanityCheckTests, orderStatisticsMatchSortedOrder)
+{
+    for (bool balancing : {true, false})
+    {
+        AVLSet<int> s{balancing};
+        std::set<int> expected;
+        std::mt19937 engine{1};
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            int element = engine() % 1000;
+            if (engine() % 3 == 0)
+            {
+                s.remove(element);
+                expected.erase(element);
+            }
+            else
+            {
+                s.add(element);
+                expected.insert(element);
+            }
+        }
+
+        std::vector<int> sorted{expected.begin(), expected.end()};
+        ASSERT_EQ(sorted.size(), s.size());
+
+        for (unsigned int i = 0; i < sorted.size(); ++i)
+        {
+            EXPECT_EQ(sorted[i], s.select(i));
+            EXPECT_EQ(i, s.rank(sorted[i]));
+        }
+
+        EXPECT_THROW(s.select(sorted.size()), std::out_of_range);
+        EXPECT_EQ(0, s.rank(-1));
+        EXPECT_EQ(sorted.size(), s.rank(1000));
+
+        for (int lo = -1; lo <= 1000; lo += 37)
+        {
+            for (int hi = lo - 5; hi <= 1000; hi += 53)
+            {
+                unsigned int count = 0;
+                for (int element : sorted)
+                {
+                    count += lo <= element && element <= hi;
+                }
+                EXPECT_EQ(count, s.countInRange(lo, hi));
+            }
+        }
+
+        AVLSet<int> copy{s};
+        EXPECT_EQ(sorted.back(), copy.select(copy.size() - 1));
+
+        AVLSet<int> merged = s.setUnion(AVLSet<int>{});
+        EXPECT_EQ(sorted[sorted.size() / 2], merged.select(sorted.size() / 2));
+    }
+}
+
+
+TEST(AVLSet_SanityCheckTests, comparisonSpecializationOrdersEverything)
+{
+    AVLSet<ReversedKey> s1;
+    AVLSet<ReversedKey> s2;
+    for (int i = 0; i < 100; ++i)
+    {
+        s1.add(ReversedKey{i});
+        s1.add(ReversedKey{i});
+        if (i % 2 == 0)
+        {
+            s2.add(ReversedKey{i});
+        }
+    }
+    s1.remove(ReversedKey{50});
+
+    EXPECT_EQ(99, s1.size());
+    EXPECT_FALSE(s1.contains(ReversedKey{50}));
+    EXPECT_TRUE(s1.contains(ReversedKey{51}));
+    EXPECT_EQ(99, s1.select(0).value);
+    EXPECT_EQ(1, s1.rank(ReversedKey{98}));
+
+    std::vector<int> visited;
+    s1.inorder([&visited](const ReversedKey& key) { visited.push_back(key.value); });
+    EXPECT_TRUE(std::is_sorted(visited.rbegin(), visited.rend()));
+
+    AVLSet<ReversedKey> odd = s1.setDifference(s2);
+    EXPECT_EQ(50, odd.size());
+    EXPECT_TRUE(odd.contains(ReversedKey{99}));
+    EXPECT_FALSE(odd.contains(ReversedKey{98}));
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include "BloomFilter.hpp"
+
+
+TEST(BloomFilter_SanityCheckTests, neverRejectsInsertedHashes)
+{
+    BloomFilter f1{1000};
+
+    for (unsigned int i = 0; i < 1000; ++i)
+    {
+        f1.insert(i * 7919);
+    }
+
+    for (unsigned int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(f1.mayContain(i * 7919));
+    }
+}
+
+
+TEST(BloomFilter_SanityCheckTests, falsePositiveRateFollowsBitsPerKey)
+{
+    BloomFilter f1{10000, 10};
+    BloomFilter f2{10000, 4};
+
+    for (unsigned int i = 0; i < 10000; ++i)
+    {
+        f1.insert(i);
+        f2.insert(i);
+    }
+
+    unsigned int falsePositives1 = 0;
+    unsigned int falsePositives2 = 0;
+    for (unsigned int i = 10000; i < 110000; ++i)
+    {
+        falsePositives1 += f1.mayContain(i);
+        falsePositives2 += f2.mayContain(i);
+    }
+
+    EXPECT_LT(falsePositives1, 2000);
+    EXPECT_LT(falsePositives1, falsePositives2);
+    EXPECT_EQ(10000 * 10 / 512 + 1, f1.blockCount());
+}
+
+
+TEST(BloomFilter_SanityCheckTests, countersAreCopied)
+{
+    BloomFilter f1{10};
+    f1.countRejection();
+    f1.countRejection();
+    f1.countFalsePositive();
+
+    BloomFilter f2{f1};
+    f2.addStats(BloomFilterStats{1, 1});
+
+    EXPECT_EQ(2, f1.stats().rejections);
+    EXPECT_EQ(3, f2.stats().rejections);
+    EXPECT_EQ(2, f2.stats().falsePositives);
+}
@@ -0,0 +1,116 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ConcurrentHashSet.hpp"
+
+
+namespace
+{
+    template <typename T>
+    unsigned int zeroHash(const T&)
+    {
+        return 0;
+    }
+
+
+    unsigned int spreadHash(const int& i)
+    {
+        return static_cast<unsigned int>(i) * 2654435761u;
+    }
+}
+
+
+TEST(ConcurrentHashSet_SanityCheckTests, canBeUsedThroughSet)
+{
+    // The elements are spread across the shards, but size() and contains()
+    // see all of them.
+    ConcurrentHashSet<int> s1{spreadHash, 4};
+    Set<int>& ss1 = s1;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ss1.add(i);
+    }
+
+    EXPECT_EQ(100, ss1.size());
+    EXPECT_TRUE(ss1.contains(0));
+    EXPECT_TRUE(ss1.contains(99));
+    EXPECT_FALSE(ss1.contains(100));
+}
+
+
+TEST(ConcurrentHashSet_SanityCheckTests, shardCountIsRoundedUpToPowerOfTwo)
+{
+    ConcurrentHashSet<int> s1{zeroHash<int>, 5};
+    EXPECT_EQ(8, s1.shardCount());
+
+    ConcurrentHashSet<int> s2{zeroHash<int>, 1};
+    EXPECT_EQ(1, s2.shardCount());
+}
+
+
+TEST(ConcurrentHashSet_SanityCheckTests, containsElementsAfterAdding)
+{
+    ConcurrentHashSet<int> s1{zeroHash<int>};
+    s1.add(11);
+    s1.add(1);
+    s1.add(5);
+    s1.add(11);
+
+    EXPECT_TRUE(s1.contains(11));
+    EXPECT_TRUE(s1.contains(1));
+    EXPECT_TRUE(s1.contains(5));
+    EXPECT_FALSE(s1.contains(21));
+    EXPECT_EQ(3, s1.size());
+    EXPECT_EQ(3, s1.elementsInShard(0));
+}
+
+
+TEST(ConcurrentHashSet_SanityCheckTests, removeUpdatesSize)
+{
+    ConcurrentHashSet<int> s1{zeroHash<int>};
+    s1.add(11);
+    s1.add(1);
+
+    s1.remove(11);
+    s1.remove(11);
+
+    EXPECT_FALSE(s1.contains(11));
+    EXPECT_TRUE(s1.contains(1));
+    EXPECT_EQ(1, s1.size());
+}
+
+
+TEST(ConcurrentHashSet_SanityCheckTests, canAddAndLookUpFromManyThreads)
+{
+    ConcurrentHashSet<int> s1{spreadHash, 16};
+    std::vector<std::thread> threads;
+
+    // Every thread adds every element, so there are plenty of duplicates
+    // racing each other into the same shards.
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 2000; ++i)
+            {
+                s1.add(i);
+                EXPECT_TRUE(s1.contains(i));
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(2000, s1.size());
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        EXPECT_TRUE(s1.contains(i));
+    }
+
+    EXPECT_FALSE(s1.contains(2000));
+}
@@ -0,0 +1,173 @@
+#include <string>
+#include <gtest/gtest.h>
+#include "CuckooHashSet.hpp"
+
+
+namespace
+{
+    template <typename T>
+    unsigned int zeroHash(const T&)
+    {
+        return 0;
+    }
+
+
+    unsigned int identityHash(const int& i)
+    {
+        return i;
+    }
+}
+
+
+TEST(CuckooHashSet_SanityCheckTests, canBeUsedThroughSet)
+{
+    // Every element has the same first bucket, so all but the first few
+    // are placed by the default second hash function.
+    CuckooHashSet<int> s1{zeroHash<int>};
+    Set<int>& ss1 = s1;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ss1.add(i);
+    }
+
+    EXPECT_EQ(100, ss1.size());
+    EXPECT_TRUE(ss1.contains(0));
+    EXPECT_TRUE(ss1.contains(99));
+    EXPECT_FALSE(ss1.contains(100));
+}
+
+
+TEST(CuckooHashSet_SanityCheckTests, canCopyAndMove)
+{
+    CuckooHashSet<std::string> s1{zeroHash<std::string>};
+    s1.add("HELLO");
+
+    CuckooHashSet<std::string> s2{s1};
+    CuckooHashSet<std::string> s3{std::move(s1)};
+    s2 = s3;
+    s3 = std::move(s2);
+
+    EXPECT_TRUE(s3.contains("HELLO"));
+    EXPECT_TRUE(s3.isImplemented());
+}
+
+
+TEST(CuckooHashSet_SanityCheckTests, containsElementsAfterAdding)
+{
+    CuckooHashSet<int> s1{identityHash};
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        s1.add(i * 7);
+        s1.add(i * 7);
+    }
+
+    EXPECT_EQ(10000, s1.size());
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        EXPECT_TRUE(s1.contains(i * 7));
+        EXPECT_FALSE(s1.contains(i * 7 + 1));
+    }
+}
+
+
+TEST(CuckooHashSet_SanityCheckTests, secondHashRescuesCollidingFirstHash)
+{
+    CuckooHashSet<std::string> s1{zeroHash<std::string>};
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s1.add(std::to_string(i));
+    }
+
+    EXPECT_EQ(1000, s1.size());
+    EXPECT_LE(s1.stashSize(), CuckooHashSet<std::string>::STASH_SIZE);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(s1.contains(std::to_string(i)));
+        EXPECT_FALSE(s1.contains(std::to_string(i + 1000)));
+    }
+}
+
+
+TEST(CuckooHashSet_SanityCheckTests, defaultSecondHashIsIndependentOfProjectHashes)
+{
+    // If the second hash were the same function as the first, every
+    // element's two buckets would be one and the same, and the set would
+    // have to keep growing to make room.
+    CuckooHashSet<std::string> s1{hashing::hashString};
+    CuckooHashSet<int> s2{[](const int& i) { return hashing::hashInteger(i); }};
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        s1.add("WORD" + std::to_string(i));
+        s2.add(i);
+    }
+
+    // 20000 elements fit in 8192 buckets of four without exceeding the
+    // load factor of 0.9.
+    EXPECT_EQ(8192, s1.bucketCount());
+    EXPECT_EQ(0, s1.stashSize());
+    EXPECT_EQ(8192, s2.bucketCount());
+    EXPECT_EQ(0, s2.stashSize());
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        EXPECT_TRUE(s1.contains("WORD" + std::to_string(i)));
+        EXPECT_TRUE(s2.contains(i));
+    }
+}
+
+
+TEST(CuckooHashSet_SanityCheckTests, identicalHashesOverflowIntoStash)
+{
+    CuckooHashSet<int> s1{zeroHash<int>, zeroHash<int>};
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s1.add(i);
+    }
+
+    // Only BUCKET_WIDTH elements fit in bucket 0; the rest are stashed.
+    EXPECT_EQ(100, s1.size());
+    EXPECT_EQ(100 - CuckooHashSet<int>::BUCKET_WIDTH, s1.stashSize());
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(s1.contains(i));
+    }
+
+    EXPECT_FALSE(s1.contains(100));
+}
+
+
+TEST(CuckooHashSet_SanityCheckTests, removeTakesElementsOut)
+{
+    CuckooHashSet<int> s1{zeroHash<int>, zeroHash<int>};
+    CuckooHashSet<int> s2{identityHash};
+
+    for (int i = 0; i < 20; ++i)
+    {
+        s1.add(i);
+        s2.add(i);
+    }
+
+    for (int i = 0; i < 20; i += 2)
+    {
+        s1.remove(i);
+        s2.remove(i);
+    }
+    s1.remove(100);
+
+    EXPECT_EQ(10, s1.size());
+    EXPECT_EQ(10, s2.size());
+
+    for (int i = 0; i < 20; ++i)
+    {
+        EXPECT_EQ(i % 2 == 1, s1.contains(i));
+        EXPECT_EQ(i % 2 == 1, s2.contains(i));
+    }
+}
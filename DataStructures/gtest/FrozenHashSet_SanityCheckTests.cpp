@@ -0,0 +1,114 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "FrozenHashSet.hpp"
+#include "WordChecker.hpp"
+
+
+namespace
+{
+    template <typename T>
+    unsigned int zeroHash(const T&)
+    {
+        return 0;
+    }
+}
+
+
+TEST(FrozenHashSet_SanityCheckTests, canBeUsedThroughSet)
+{
+    FrozenHashSet<std::string> s1{std::vector<std::string>{"Boo", "is", "happy", "is"}};
+    Set<std::string>& ss1 = s1;
+
+    EXPECT_EQ(3, ss1.size());
+    EXPECT_TRUE(ss1.contains("happy"));
+    EXPECT_FALSE(ss1.contains("today"));
+    EXPECT_THROW(ss1.add("today"), std::logic_error);
+
+    FrozenHashSet<int> s2{std::vector<int>{}};
+    EXPECT_EQ(0, s2.size());
+    EXPECT_FALSE(s2.contains(0));
+}
+
+
+TEST(FrozenHashSet_SanityCheckTests, containsExactlyTheElementsItWasBuiltFrom)
+{
+    std::vector<int> elements;
+    for (int i = 0; i < 10000; ++i)
+    {
+        elements.push_back(i * 1280);
+    }
+
+    FrozenHashSet<int> s1{elements};
+    EXPECT_TRUE(s1.isImplemented());
+    EXPECT_EQ(10000, s1.size());
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        EXPECT_TRUE(s1.contains(i * 1280));
+        EXPECT_FALSE(s1.contains(i * 1280 + 1));
+    }
+}
+
+
+TEST(FrozenHashSet_SanityCheckTests, storesDuplicatesOnce)
+{
+    FrozenHashSet<std::string> s1{std::vector<std::string>{"HELLO", "THERE", "HELLO", "BOO"}};
+
+    EXPECT_EQ(3, s1.size());
+    EXPECT_TRUE(s1.contains("HELLO"));
+    EXPECT_TRUE(s1.contains("THERE"));
+    EXPECT_TRUE(s1.contains("BOO"));
+    EXPECT_FALSE(s1.contains("BOOK"));
+}
+
+
+TEST(FrozenHashSet_SanityCheckTests, emptySetContainsNothing)
+{
+    FrozenHashSet<std::string> s1{std::vector<std::string>{}};
+
+    EXPECT_EQ(0, s1.size());
+    EXPECT_FALSE(s1.contains("HELLO"));
+}
+
+
+TEST(FrozenHashSet_SanityCheckTests, canBeBuiltFromHashSet)
+{
+    HashSet<std::string> s1{zeroHash<std::string>};
+    s1.add("HELLO");
+    s1.add("THERE");
+
+    FrozenHashSet<std::string> s2{s1};
+
+    EXPECT_EQ(2, s2.size());
+    EXPECT_TRUE(s2.contains("HELLO"));
+    EXPECT_TRUE(s2.contains("THERE"));
+}
+
+
+TEST(FrozenHashSet_SanityCheckTests, cannotAddElements)
+{
+    FrozenHashSet<int> s1{std::vector<int>{1, 2, 3}};
+
+    EXPECT_THROW(s1.add(4), std::logic_error);
+    EXPECT_FALSE(s1.contains(4));
+}
+
+
+TEST(FrozenHashSet_SanityCheckTests, distinctElementsWithSameHashAreRejected)
+{
+    EXPECT_THROW(
+        (FrozenHashSet<int>{std::vector<int>{1, 2}, [](const int&) { return std::uint64_t{0}; }}),
+        std::invalid_argument);
+}
+
+
+TEST(FrozenHashSet_SanityCheckTests, canBeUsedByWordChecker)
+{
+    FrozenHashSet<std::string> set{std::vector<std::string>{"HELLO", "THERE", "BOO"}};
+    WordChecker checker{set};
+
+    EXPECT_TRUE(checker.wordExists("HELLO"));
+    EXPECT_FALSE(checker.wordExists("HELLOTHERE"));
+}
@@ -1,5 +1,10 @@
 
+#include <algorithm>
+#include <atomic>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <gtest/gtest.h>
 #include "HashSet.hpp"
 
@@ -147,3 +152,609 @@ TEST(HashSet_SanityCheckTests, elementsAtIndexAccordingToHash)
     EXPECT_FALSE(s1.isElementAtIndex(5, 1));
 }
 
+
+
+TEST(HashSet_SanityCheckTests, containsElementsAfterResizing)
+{
+    HashSet<int> s1{[](const int& i) { return static_cast<unsigned int>(i); }};
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s1.add(i * 7);
+        s1.add(i * 7);
+    }
+
+    EXPECT_EQ(1000, s1.size());
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(s1.contains(i * 7));
+        EXPECT_TRUE(s1.contains(i * 7));
+        EXPECT_FALSE(s1.contains(i * 7 + 1));
+    }
+}
+
+
+TEST(HashSet_SanityCheckTests, containsElementsWhileResizingIncrementally)
+{
+    HashSet<int> s1{[](const int& i) { return static_cast<unsigned int>(i); }, true};
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s1.add(i * 7);
+        s1.add(i * 7);
+
+        EXPECT_TRUE(s1.contains(i * 7));
+        EXPECT_TRUE(s1.contains(i / 2 * 7));
+    }
+
+    EXPECT_EQ(1000, s1.size());
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(s1.contains(i * 7));
+        EXPECT_FALSE(s1.contains(i * 7 + 1));
+    }
+}
+
+
+TEST(HashSet_SanityCheckTests, resizingDoesNotRehashCachedElements)
+{
+    unsigned int hashCalls = 0;
+    HashSet<std::string> s1{[&](const std::string& s) {
+        ++hashCalls;
+        return static_cast<unsigned int>(s.size());
+    }};
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s1.add(std::to_string(i));
+    }
+
+    // One call per add(), no matter how many resizes happened.
+    EXPECT_EQ(100, hashCalls);
+    EXPECT_TRUE(s1.contains("42"));
+    EXPECT_FALSE(s1.contains("420"));
+}
+
+
+TEST(HashSet_SanityCheckTests, canAllocateNodesFromMemoryResource)
+{
+    std::pmr::monotonic_buffer_resource arena;
+    HashSet<std::string> s1{zeroHash<std::string>, false, &arena};
+    s1.add("HELLO");
+    s1.add("THERE");
+
+    HashSet<std::string> s2{s1};
+    HashSet<std::string> s3{std::move(s1)};
+
+    EXPECT_TRUE(s3.contains("HELLO"));
+    EXPECT_TRUE(s3.contains("THERE"));
+    EXPECT_EQ(2, s2.size());
+}
+
+
+namespace
+{
+    struct TransparentLengthHash
+    {
+        using is_transparent = void;
+
+        unsigned int operator()(std::string_view s) const
+        {
+            return s.size();
+        }
+    };
+}
+
+
+TEST(HashSet_SanityCheckTests, canLookUpStringViewsWithTransparentHash)
+{
+    HashSet<std::string> s1{TransparentLengthHash{}};
+    s1.add("HELLO");
+    s1.add("THERE");
+    s1.add("BOO");
+
+    char buffer[] = "BOOK";
+    std::string_view prefix{buffer, 3};
+
+    EXPECT_TRUE(s1.contains(std::string_view{"HELLO"}));
+    EXPECT_TRUE(s1.contains("THERE"));
+    EXPECT_TRUE(s1.contains(prefix));
+    EXPECT_FALSE(s1.contains(buffer));
+    EXPECT_TRUE(s1.isElementAtIndex("BOO", 3));
+    EXPECT_EQ(3, s1.size());
+}
+
+
+TEST(HashSet_SanityCheckTests, canLookUpStringViewsWithoutTransparentHash)
+{
+    HashSet<std::string> s1{zeroHash<std::string>};
+    s1.add("HELLO");
+
+    EXPECT_TRUE(s1.contains(std::string_view{"HELLO"}));
+    EXPECT_FALSE(s1.contains("THERE"));
+}
+
+
+TEST(HashSet_SanityCheckTests, copiesKeepTheirHashFunction)
+{
+    HashSet<int> s1{[](const int& i) { return static_cast<unsigned int>(i); }};
+    for (int i = 0; i < 100; ++i)
+    {
+        s1.add(i);
+    }
+
+    HashSet<int> s2{s1};
+    HashSet<int> s3{zeroHash<int>};
+    s3 = s1;
+    HashSet<int> s4{std::move(s1)};
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(s2.contains(i));
+        EXPECT_TRUE(s3.contains(i));
+        EXPECT_TRUE(s4.contains(i));
+    }
+
+    s2.add(100);
+    EXPECT_TRUE(s2.isElementAtIndex(100, 100));
+}
+
+
+TEST(HashSet_SanityCheckTests, canUseCompileTimeHasher)
+{
+    HashSet<std::string, DefaultHasher<std::string>> s1;
+    s1.add("HELLO");
+    s1.add("THERE");
+
+    HashSet<int, DefaultHasher<int>> s2;
+    s2.add(11);
+
+    EXPECT_TRUE(s1.contains("HELLO"));
+    EXPECT_TRUE(s1.contains(std::string_view{"THERE"}));
+    EXPECT_FALSE(s1.contains(std::string{"BOO"}));
+    EXPECT_TRUE(s2.contains(11));
+    EXPECT_FALSE(s2.contains(5));
+}
+
+
+TEST(HashSet_SanityCheckTests, containsBatchMatchesContains)
+{
+    HashSet<int> s1{[](const int& i) { return static_cast<unsigned int>(i); }, true};
+
+    for (int i = 0; i < 520; ++i)
+    {
+        s1.add(i * 3);
+    }
+
+    // Partway through an incremental resize (the array grows from 640 to
+    // 1280 buckets at the 513th element), some elements are still in the
+    // old array.
+    ASSERT_GT(s1.stats().bucketsToMove, 0);
+    EXPECT_TRUE(s1.contains(1557));
+
+    int elements[100];
+    bool results[100];
+    for (int i = 0; i < 100; ++i)
+    {
+        elements[i] = i * 31;
+    }
+
+    s1.containsBatch(elements, 100, results);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(s1.contains(elements[i]), results[i]);
+    }
+}
+
+
+TEST(HashSet_SanityCheckTests, bloomFilterRejectsMostMisses)
+{
+    HashSet<int> s1{[](const int& i) { return static_cast<unsigned int>(i); }};
+    s1.add(-1);
+    s1.enableBloomFilter();
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        s1.add(i * 2);
+    }
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        EXPECT_TRUE(s1.contains(i * 2));
+        EXPECT_FALSE(s1.contains(i * 2 + 1));
+    }
+
+    EXPECT_TRUE(s1.contains(-1));
+
+    BloomFilterStats stats = s1.bloomFilterStats();
+    EXPECT_EQ(10000, stats.rejections + stats.falsePositives);
+    EXPECT_LT(stats.falsePositives, 500);
+
+    HashSet<int> s2{s1};
+    EXPECT_EQ(stats.rejections, s2.bloomFilterStats().rejections);
+    EXPECT_TRUE(s2.contains(42));
+
+    // The copies share the filter, but not its counters.
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_FALSE(s2.contains(i * 2 + 1));
+    }
+    EXPECT_EQ(100, s2.bloomFilterStats().rejections + s2.bloomFilterStats().falsePositives
+        - stats.rejections - stats.falsePositives);
+    EXPECT_EQ(stats.rejections, s1.bloomFilterStats().rejections);
+    EXPECT_EQ(stats.falsePositives, s1.bloomFilterStats().falsePositives);
+
+    s1.disableBloomFilter();
+    EXPECT_EQ(0, s1.bloomFilterStats().rejections);
+    EXPECT_TRUE(s1.contains(42));
+}
+
+
+TEST(HashSet_SanityCheckTests, removeUnlinksElements)
+{
+    HashSet<std::string> s1{zeroHash<std::string>};
+    s1.add("HELLO");
+    s1.add("THERE");
+    s1.add("BOO");
+
+    s1.remove("THERE");
+    s1.remove("NOTTHERE");
+
+    EXPECT_EQ(2, s1.size());
+    EXPECT_EQ(2, s1.elementsAtIndex(0));
+    EXPECT_TRUE(s1.contains("HELLO"));
+    EXPECT_FALSE(s1.contains("THERE"));
+    EXPECT_TRUE(s1.contains("BOO"));
+}
+
+
+TEST(HashSet_SanityCheckTests, removeShrinksAfterMassDeletion)
+{
+    for (bool incremental : {false, true})
+    {
+        HashSet<int> s1{[](const int& i) { return static_cast<unsigned int>(i); }, incremental};
+
+        for (int i = 0; i < 10000; ++i)
+        {
+            s1.add(i);
+        }
+
+        unsigned int grownCapacity = s1.bucketCount();
+
+        for (int i = 0; i < 10000; ++i)
+        {
+            if (i % 100 != 0)
+            {
+                s1.remove(i);
+            }
+        }
+
+        EXPECT_EQ(100, s1.size());
+        EXPECT_LT(s1.bucketCount(), grownCapacity / 16);
+
+        for (int i = 0; i < 10000; ++i)
+        {
+            EXPECT_EQ(i % 100 == 0, s1.contains(i));
+        }
+
+        s1.add(1);
+        EXPECT_TRUE(s1.contains(1));
+    }
+}
+
+
+TEST(HashSet_SanityCheckTests, removeNeverShrinksBelowDefaultCapacity)
+{
+    HashSet<int> s1{[](const int& i) { return static_cast<unsigned int>(i); }};
+    s1.reserve(10);
+    ASSERT_GT(s1.bucketCount(), HashSet<int>::DEFAULT_CAPACITY);
+
+    s1.add(1);
+    s1.remove(1);
+
+    EXPECT_EQ(HashSet<int>::DEFAULT_CAPACITY, s1.bucketCount());
+}
+
+
+TEST(HashSet_SanityCheckTests, elementsAtIndexAddsUpToSizeWhileShrinking)
+{
+    HashSet<int> s1{[](const int& i) { return static_cast<unsigned int>(i); }, true};
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        s1.add(i);
+    }
+
+    auto countAll = [&s1]() {
+        unsigned int total = 0;
+        for (unsigned int i = 0; i < s1.bucketCount(); ++i)
+        {
+            total += s1.elementsAtIndex(i);
+        }
+        return total;
+    };
+
+    // Removing elements until the array is halved leaves the elements for
+    // each new index spread across two buckets of the old one.
+    unsigned int grownCapacity = s1.bucketCount();
+    int next = 0;
+
+    while (s1.bucketCount() == grownCapacity)
+    {
+        s1.remove(next++);
+    }
+
+    EXPECT_EQ(grownCapacity / 2, s1.bucketCount());
+    ASSERT_GT(s1.stats().bucketsToMove, 0);
+
+    while (s1.stats().bucketsToMove > 0)
+    {
+        EXPECT_EQ(s1.size(), countAll());
+        s1.remove(next++);
+    }
+
+    EXPECT_EQ(s1.size(), countAll());
+}
+
+
+TEST(HashSet_SanityCheckTests, rangeConstructorAddsEachElementOnce)
+{
+    // Enough elements that they're hashed on several threads, with every
+    // one appearing twice.
+    std::vector<int> elements;
+    for (int i = 0; i < 100000; ++i)
+    {
+        elements.push_back(i);
+        elements.push_back(i);
+    }
+
+    HashSet<int, DefaultHasher<int>> s1{elements.begin(), elements.end()};
+    EXPECT_EQ(100000, s1.size());
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        EXPECT_TRUE(s1.contains(i));
+    }
+
+    EXPECT_FALSE(s1.contains(100000));
+
+    std::vector<std::string> words{"Boo", "is", "happy", "today", "is"};
+    HashSet<std::string> s2{words.begin(), words.end(), zeroHash<std::string>};
+    EXPECT_EQ(4, s2.size());
+    EXPECT_TRUE(s2.contains("happy"));
+}
+
+
+TEST(HashSet_SanityCheckTests, reserveAvoidsResizing)
+{
+    for (bool incremental : {false, true})
+    {
+        HashSet<int> s1{[](const int& i) { return static_cast<unsigned int>(i); }, incremental};
+        s1.add(-1);
+        s1.reserve(5000);
+
+        unsigned int reservedCapacity = s1.bucketCount();
+        EXPECT_GE(reservedCapacity * 0.8, 5000);
+
+        for (int i = 0; i < 4999; ++i)
+        {
+            s1.add(i);
+        }
+
+        EXPECT_EQ(reservedCapacity, s1.bucketCount());
+        EXPECT_EQ(5000, s1.size());
+        EXPECT_TRUE(s1.contains(-1));
+
+        s1.reserve(10);
+        EXPECT_EQ(reservedCapacity, s1.bucketCount());
+    }
+}
+
+
+TEST(HashSet_SanityCheckTests, reserveChoosesTheSmallestCapacity)
+{
+    // The smallest capacity c with count <= 0.8 * c.
+    unsigned int counts[] = {10, 800, 801};
+    unsigned int capacities[] = {13, 1000, 1002};
+
+    for (int t = 0; t < 3; ++t)
+    {
+        HashSet<int> s1{[](const int& i) { return static_cast<unsigned int>(i); }};
+        s1.reserve(counts[t]);
+        EXPECT_EQ(capacities[t], s1.bucketCount());
+    }
+
+    // Eight elements already fit in the default ten buckets.
+    HashSet<int> s2{[](const int& i) { return static_cast<unsigned int>(i); }};
+    s2.reserve(8);
+    EXPECT_EQ(10, s2.bucketCount());
+
+    for (int i = 0; i < 8; ++i)
+    {
+        s2.add(i);
+    }
+    EXPECT_EQ(10, s2.bucketCount());
+}
+
+
+TEST(HashSet_SanityCheckTests, statsDescribeChainsAndCountProbes)
+{
+    HashSet<int> s1{zeroHash<int>};
+    for (int i = 0; i < 20; ++i)
+    {
+        s1.add(i);
+    }
+
+    HashSetStats stats = s1.stats();
+    EXPECT_EQ(20, stats.size);
+    EXPECT_EQ(s1.bucketCount(), stats.bucketCount);
+    EXPECT_DOUBLE_EQ(20.0 / s1.bucketCount(), stats.loadFactor);
+    EXPECT_DOUBLE_EQ(1.0 - 1.0 / s1.bucketCount(), stats.emptyBucketRatio);
+    EXPECT_DOUBLE_EQ(20.0, stats.meanChainLength);
+    EXPECT_EQ(20, stats.p99ChainLength);
+    EXPECT_EQ(20, stats.maxChainLength);
+    EXPECT_EQ(2, stats.resizes);
+    EXPECT_EQ(0, stats.lookups);
+
+    // Every element is in one chain, so each miss examines all of them.
+    EXPECT_FALSE(s1.contains(20));
+    EXPECT_FALSE(s1.contains(-1));
+    EXPECT_TRUE(s1.contains(7));
+
+    stats = s1.stats();
+
+    if (HASHSET_COUNT_PROBES)
+    {
+        EXPECT_EQ(3, stats.lookups);
+        EXPECT_GE(stats.probes, 41);
+        EXPECT_LE(stats.probes, 60);
+    }
+    else
+    {
+        EXPECT_EQ(0, stats.lookups);
+        EXPECT_EQ(0, stats.probes);
+    }
+}
+
+
+TEST(HashSet_SanityCheckTests, setAlgebraMatchesContains)
+{
+    // Large enough that the lookups are split across threads.
+    HashSet<int, DefaultHasher<int>> evens;
+    HashSet<int, DefaultHasher<int>> threes;
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        evens.add(i * 2);
+        threes.add(i * 3);
+    }
+
+    auto both = evens.setIntersection(threes);
+    auto bothReversed = threes.setIntersection(evens);
+    auto either = evens.setUnion(threes);
+    auto onlyEvens = evens.setDifference(threes);
+
+    EXPECT_EQ(33334, both.size());
+    EXPECT_EQ(33334, bothReversed.size());
+    EXPECT_EQ(166666, either.size());
+    EXPECT_EQ(66666, onlyEvens.size());
+
+    for (int i = 0; i < 300000; ++i)
+    {
+        bool isEven = i % 2 == 0 && i < 200000;
+        bool isThree = i % 3 == 0;
+        EXPECT_EQ(isEven && isThree, both.contains(i));
+        EXPECT_EQ(isEven || isThree, either.contains(i));
+        EXPECT_EQ(isEven && !isThree, onlyEvens.contains(i));
+    }
+}
+
+
+TEST(HashSet_SanityCheckTests, iteratorsVisitEveryElementOnce)
+{
+    for (bool incremental : {false, true})
+    {
+        HashSet<int> s1{[](const int& i) { return static_cast<unsigned int>(i); }, incremental};
+        EXPECT_TRUE(s1.begin() == s1.end());
+
+        // The array grows from 640 to 1280 buckets at the 513th element,
+        // and each later add() moves four buckets, so after 600 elements an
+        // incremental resize is still in progress and the old array is
+        // visited too.
+        for (int i = 0; i < 600; ++i)
+        {
+            s1.add(i);
+        }
+        EXPECT_EQ(incremental, s1.stats().bucketsToMove > 0);
+
+        std::vector<int> visited{s1.begin(), s1.end()};
+        std::sort(visited.begin(), visited.end());
+        ASSERT_EQ(600, visited.size());
+
+        for (int i = 0; i < 600; ++i)
+        {
+            EXPECT_EQ(i, visited[i]);
+        }
+
+        long long sum = 0;
+        s1.forEach([&sum](int i) { sum += i; });
+        EXPECT_EQ(599 * 600 / 2, sum);
+
+        std::atomic<long long> parallelSum{0};
+        s1.parallelForEach([&parallelSum](int i) { parallelSum += i; });
+        EXPECT_EQ(599 * 600 / 2, parallelSum.load());
+    }
+}
+
+
+TEST(HashSet_SanityCheckTests, parallelForEachVisitsEveryElementOnce)
+{
+    HashSet<int, DefaultHasher<int>> s1;
+    for (int i = 0; i < 100000; ++i)
+    {
+        s1.add(i);
+    }
+
+    std::atomic<long long> sum{0};
+    std::atomic<int> count{0};
+
+    s1.parallelForEach([&](int i) {
+        sum += i;
+        ++count;
+    });
+
+    EXPECT_EQ(100000, count.load());
+    EXPECT_EQ(99999LL * 100000 / 2, sum.load());
+}
+
+
+TEST(HashSet_SanityCheckTests, copiesAreUnaffectedByLaterChanges)
+{
+    for (bool incremental : {false, true})
+    {
+        HashSet<int, DefaultHasher<int>> s1{DefaultHasher<int>{}, incremental};
+        // After 600 elements, an incremental resize is still in progress, so
+        // the copies share the old array as well as the new one.
+        for (int i = 0; i < 600; ++i)
+        {
+            s1.add(i);
+        }
+        s1.enableBloomFilter();
+        EXPECT_EQ(incremental, s1.stats().bucketsToMove > 0);
+
+        HashSet<int, DefaultHasher<int>> s2{s1};
+        HashSet<int, DefaultHasher<int>> s3 = s1;
+
+        s1.add(1000);
+        s1.remove(0);
+        s2.remove(1);
+        s2.remove(5000);
+
+        EXPECT_TRUE(s1.contains(1000));
+        EXPECT_FALSE(s1.contains(0));
+        EXPECT_TRUE(s1.contains(1));
+        EXPECT_EQ(600, s1.size());
+
+        EXPECT_FALSE(s2.contains(1000));
+        EXPECT_TRUE(s2.contains(0));
+        EXPECT_FALSE(s2.contains(1));
+        EXPECT_EQ(599, s2.size());
+
+        EXPECT_FALSE(s3.contains(1000));
+        EXPECT_TRUE(s3.contains(0));
+        EXPECT_TRUE(s3.contains(1));
+        EXPECT_EQ(600, s3.size());
+        EXPECT_EQ(600, std::distance(s3.begin(), s3.end()));
+        EXPECT_EQ(incremental, s3.stats().bucketsToMove > 0);
+
+        // s2's own storage, copied from the shared one mid-resize, still
+        // holds every element but the one it removed.
+        for (int i = 2; i < 600; ++i)
+        {
+            EXPECT_TRUE(s2.contains(i));
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#include <set>
+#include <string>
+#include <gtest/gtest.h>
+#include "Hashing.hpp"
+#include "HashSet.hpp"
+
+
+TEST(Hashing_SanityCheckTests, hashBytesIsDeterministic)
+{
+    std::string s = "HELLO THERE";
+
+    EXPECT_EQ(hashing::hashBytes(s.data(), s.size()), hashing::hashBytes(s.data(), s.size()));
+    EXPECT_EQ(hashing::hashString(s), hashing::hashString(std::string{s}));
+    EXPECT_NE(hashing::hashBytes(s.data(), s.size(), 1), hashing::hashBytes(s.data(), s.size(), 2));
+}
+
+
+TEST(Hashing_SanityCheckTests, hashBytesDistinguishesEveryLength)
+{
+    // Prefixes of one string cover every path through hashBytes(), from
+    // empty strings to those long enough to use all three lanes.
+    std::string s;
+    for (int i = 0; i < 200; ++i)
+    {
+        s += static_cast<char>('A' + i % 26);
+    }
+
+    std::set<std::uint64_t> hashes;
+    for (std::size_t length = 0; length <= s.size(); ++length)
+    {
+        hashes.insert(hashing::hashBytes(s.data(), length));
+    }
+
+    EXPECT_EQ(s.size() + 1, hashes.size());
+}
+
+
+TEST(Hashing_SanityCheckTests, hashBytesDependsOnEveryByte)
+{
+    std::string s(64, 'A');
+    std::uint64_t original = hashing::hashBytes(s.data(), s.size());
+
+    for (std::size_t i = 0; i < s.size(); ++i)
+    {
+        std::string changed = s;
+        changed[i] = 'B';
+        EXPECT_NE(original, hashing::hashBytes(changed.data(), changed.size()));
+    }
+}
+
+
+TEST(Hashing_SanityCheckTests, mixIntegerSpreadsStridedKeys)
+{
+    HashSet<int, DefaultHasher<int>> s1;
+
+    // Multiples of 1280 all land in bucket 0 under an identity hash, for
+    // every capacity this HashSet reaches.
+    for (int i = 0; i < 1000; ++i)
+    {
+        s1.add(i * 1280);
+    }
+
+    unsigned int longest = 0;
+    for (unsigned int i = 0; i < s1.bucketCount(); ++i)
+    {
+        longest = std::max(longest, s1.elementsAtIndex(i));
+    }
+
+    EXPECT_EQ(1000, s1.size());
+    EXPECT_LE(longest, 8);
+}
@@ -0,0 +1,96 @@
+#include <string>
+#include <string_view>
+#include <gtest/gtest.h>
+#include "InlineStringHashSet.hpp"
+
+
+TEST(InlineStringHashSet_SanityCheckTests, canBeUsedThroughSet)
+{
+    InlineStringHashSet s1;
+    Set<std::string>& ss1 = s1;
+    std::string longString(InlineStringHashSet::INLINE_CAPACITY + 1, 'x');
+
+    ss1.add("Boo");
+    ss1.add(longString);
+
+    EXPECT_EQ(2, ss1.size());
+    EXPECT_TRUE(ss1.contains("Boo"));
+    EXPECT_TRUE(ss1.contains(longString));
+    EXPECT_FALSE(ss1.contains("Bo"));
+}
+
+
+TEST(InlineStringHashSet_SanityCheckTests, containsShortAndLongStrings)
+{
+    InlineStringHashSet s1;
+    std::string exactlyInline(InlineStringHashSet::INLINE_CAPACITY, 'x');
+    std::string justTooLong(InlineStringHashSet::INLINE_CAPACITY + 1, 'x');
+
+    s1.add("");
+    s1.add("Boo");
+    s1.add(exactlyInline);
+    s1.add(justTooLong);
+    s1.add("pneumonoultramicroscopicsilicovolcanoconiosis");
+    s1.add("Boo");
+
+    EXPECT_EQ(5, s1.size());
+    EXPECT_TRUE(s1.contains(""));
+    EXPECT_TRUE(s1.contains("Boo"));
+    EXPECT_TRUE(s1.contains(exactlyInline));
+    EXPECT_TRUE(s1.contains(justTooLong));
+    EXPECT_TRUE(s1.contains(std::string_view{"pneumonoultramicroscopicsilicovolcanoconiosis"}));
+    EXPECT_FALSE(s1.contains("Bo"));
+    EXPECT_FALSE(s1.contains(std::string(InlineStringHashSet::INLINE_CAPACITY + 2, 'x')));
+
+    // Only the two long strings are in the arena.
+    EXPECT_EQ(justTooLong.size() + 45, s1.arenaSize());
+}
+
+
+TEST(InlineStringHashSet_SanityCheckTests, growsAndRemovesWithoutLosingStrings)
+{
+    InlineStringHashSet s1;
+
+    // Every third string is long enough to go into the arena.
+    auto word = [](int i) {
+        return i % 3 == 0 ? std::string(30, 'w') + std::to_string(i) : std::to_string(i);
+    };
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        s1.add(word(i));
+    }
+
+    EXPECT_EQ(5000, s1.size());
+    EXPECT_GE(s1.slotCount() * 0.8, 5000);
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            s1.remove(word(i));
+        }
+    }
+
+    EXPECT_EQ(2500, s1.size());
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        EXPECT_EQ(i % 2 == 1, s1.contains(word(i)));
+    }
+
+    // Removing nearly everything shrinks the table and compacts the arena.
+    for (int i = 0; i < 4990; ++i)
+    {
+        s1.remove(word(i));
+    }
+
+    EXPECT_EQ(5, s1.size());
+    EXPECT_EQ(InlineStringHashSet::DEFAULT_CAPACITY, s1.slotCount());
+    EXPECT_LT(s1.arenaSize(), 200);
+
+    for (int i = 4990; i < 5000; ++i)
+    {
+        EXPECT_EQ(i % 2 == 1, s1.contains(word(i)));
+    }
+}
@@ -0,0 +1,178 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <gtest/gtest.h>
+#include "MappedHashSet.hpp"
+#include "WordChecker.hpp"
+
+
+namespace
+{
+    template <typename T>
+    unsigned int zeroHash(const T&)
+    {
+        return 0;
+    }
+
+
+    std::string imagePath(const std::string& name)
+    {
+        return ::testing::TempDir() + "MappedHashSet_" + name + ".img";
+    }
+}
+
+
+TEST(MappedHashSet_SanityCheckTests, containsExactlyTheWrittenStrings)
+{
+    std::vector<std::string> words;
+    for (int i = 0; i < 10000; ++i)
+    {
+        words.push_back("WORD" + std::to_string(i));
+    }
+    words.push_back("WORD42");
+
+    std::string path = imagePath("words");
+    MappedHashSet::writeImage(words, path);
+    MappedHashSet s1{path};
+
+    EXPECT_TRUE(s1.isImplemented());
+    EXPECT_EQ(10000, s1.size());
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        EXPECT_TRUE(s1.contains("WORD" + std::to_string(i)));
+        EXPECT_FALSE(s1.contains("WORD" + std::to_string(i + 10000)));
+    }
+
+    EXPECT_TRUE(s1.contains(std::string_view{"WORD7"}));
+    EXPECT_FALSE(s1.contains("WORD"));
+
+    std::remove(path.c_str());
+}
+
+
+TEST(MappedHashSet_SanityCheckTests, canBeWrittenFromHashSet)
+{
+    HashSet<std::string> s1{zeroHash<std::string>};
+    s1.add("HELLO");
+    s1.add("THERE");
+    s1.add("");
+
+    std::string path = imagePath("hashset");
+    MappedHashSet::writeImage(s1, path);
+    MappedHashSet s2{path};
+    MappedHashSet s3{std::move(s2)};
+
+    EXPECT_EQ(3, s3.size());
+    EXPECT_TRUE(s3.contains("HELLO"));
+    EXPECT_TRUE(s3.contains("THERE"));
+    EXPECT_TRUE(s3.contains(""));
+    EXPECT_FALSE(s3.contains("BOO"));
+
+    std::remove(path.c_str());
+}
+
+
+TEST(MappedHashSet_SanityCheckTests, canBeEmpty)
+{
+    std::string path = imagePath("empty");
+    MappedHashSet::writeImage(std::vector<std::string>{}, path);
+    MappedHashSet s1{path};
+
+    EXPECT_EQ(0, s1.size());
+    EXPECT_FALSE(s1.contains("HELLO"));
+
+    std::remove(path.c_str());
+}
+
+
+TEST(MappedHashSet_SanityCheckTests, rejectsFilesThatAreNotImages)
+{
+    std::string path = imagePath("garbage");
+    std::ofstream{path} << "this is not a HashSet image, but it is long enough to have a header";
+
+    EXPECT_THROW(MappedHashSet{path}, std::runtime_error);
+    EXPECT_THROW(MappedHashSet{imagePath("missing")}, std::runtime_error);
+
+    std::remove(path.c_str());
+}
+
+
+TEST(MappedHashSet_SanityCheckTests, rewritingLeavesExistingMappingsIntact)
+{
+    std::string path = imagePath("rewritten");
+    MappedHashSet::writeImage(std::vector<std::string>{"HELLO", "THERE"}, path);
+    MappedHashSet s1{path};
+
+    MappedHashSet::writeImage(std::vector<std::string>{"BOO"}, path);
+    MappedHashSet s2{path};
+
+    EXPECT_TRUE(s1.contains("HELLO"));
+    EXPECT_TRUE(s1.contains("THERE"));
+    EXPECT_EQ(2, s1.size());
+    EXPECT_TRUE(s2.contains("BOO"));
+    EXPECT_FALSE(s2.contains("HELLO"));
+    EXPECT_FALSE(std::ifstream{path + ".tmp"}.is_open());
+
+    std::remove(path.c_str());
+}
+
+
+TEST(MappedHashSet_SanityCheckTests, corruptEntriesAreNeverReadPast)
+{
+    std::string path = imagePath("corrupt");
+    std::vector<std::string> words{"HELLO", "THERE", "BOO"};
+    MappedHashSet::writeImage(words, path);
+
+    // With three strings, there are four buckets, so the 56-byte header is
+    // followed by five bucket starts and then, at offset 80, the 16-byte
+    // entries, whose last eight bytes are the offsets of their strings.
+    {
+        std::fstream image{path, std::ios::binary | std::ios::in | std::ios::out};
+        std::uint64_t farAway = std::uint64_t{1} << 40;
+        for (int i = 0; i < 3; ++i)
+        {
+            image.seekp(80 + 16 * i + 8);
+            image.write(reinterpret_cast<const char*>(&farAway), sizeof(farAway));
+        }
+    }
+
+    MappedHashSet s1{path};
+
+    for (const std::string& word : words)
+    {
+        EXPECT_FALSE(s1.contains(word));
+    }
+
+    std::remove(path.c_str());
+}
+
+
+TEST(MappedHashSet_SanityCheckTests, cannotAddElements)
+{
+    std::string path = imagePath("readonly");
+    MappedHashSet::writeImage(std::vector<std::string>{"HELLO"}, path);
+    MappedHashSet s1{path};
+
+    EXPECT_THROW(s1.add("THERE"), std::logic_error);
+
+    std::remove(path.c_str());
+}
+
+
+TEST(MappedHashSet_SanityCheckTests, canBeUsedByWordChecker)
+{
+    std::string path = imagePath("checker");
+    MappedHashSet::writeImage(std::vector<std::string>{"HELLO", "THERE", "BOO"}, path);
+    MappedHashSet set{path};
+    WordChecker checker{set};
+
+    EXPECT_TRUE(checker.wordExists("BOO"));
+    EXPECT_FALSE(checker.wordExists("BOOK"));
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,69 @@
+#include <memory_resource>
+#include <string>
+#include <gtest/gtest.h>
+#include "NodePool.hpp"
+
+
+namespace
+{
+    struct Node
+    {
+        std::string value;
+        Node* next;
+
+        Node(const std::string& value, Node* next)
+            : value{value}, next{next}
+        {
+        }
+    };
+}
+
+
+TEST(NodePool_SanityCheckTests, canCreateAndDestroyNodes)
+{
+    NodePool<Node> pool;
+    Node* list = nullptr;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        list = pool.create(std::to_string(i), list);
+    }
+
+    for (int i = 999; i >= 0; --i)
+    {
+        ASSERT_NE(nullptr, list);
+        EXPECT_EQ(std::to_string(i), list->value);
+
+        Node* next = list->next;
+        pool.destroy(list);
+        list = next;
+    }
+}
+
+
+TEST(NodePool_SanityCheckTests, reusesDestroyedNodes)
+{
+    NodePool<Node> pool;
+    Node* first = pool.create("A", nullptr);
+    pool.destroy(first);
+
+    Node* second = pool.create("B", nullptr);
+    EXPECT_EQ(first, second);
+    pool.destroy(second);
+}
+
+
+TEST(NodePool_SanityCheckTests, takesSlabsFromMemoryResource)
+{
+    char buffer[4096];
+    std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer),
+        std::pmr::null_memory_resource()};
+
+    NodePool<Node> pool{&arena};
+    EXPECT_EQ(&arena, pool.resource());
+
+    Node* node = pool.create("A", nullptr);
+    EXPECT_GE(reinterpret_cast<char*>(node), buffer);
+    EXPECT_LT(reinterpret_cast<char*>(node), buffer + sizeof(buffer));
+    pool.destroy(node);
+}
@@ -0,0 +1,125 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "RcuHashSet.hpp"
+
+
+namespace
+{
+    template <typename T>
+    unsigned int zeroHash(const T&)
+    {
+        return 0;
+    }
+}
+
+
+TEST(RcuHashSet_SanityCheckTests, canBeUsedThroughSet)
+{
+    // Each add() publishes a new array, which later searches see.
+    RcuHashSet<int> s1{zeroHash<int>};
+    Set<int>& ss1 = s1;
+
+    ss1.add(1);
+    EXPECT_TRUE(ss1.contains(1));
+    EXPECT_FALSE(ss1.contains(2));
+
+    ss1.add(2);
+    EXPECT_TRUE(ss1.contains(2));
+    EXPECT_EQ(2, ss1.size());
+}
+
+
+TEST(RcuHashSet_SanityCheckTests, containsElementsAfterAdding)
+{
+    RcuHashSet<std::string> s1{zeroHash<std::string>};
+    s1.add("Boo");
+    s1.add("is");
+    s1.add("happy");
+    s1.add("Boo");
+
+    EXPECT_TRUE(s1.contains("Boo"));
+    EXPECT_TRUE(s1.contains("is"));
+    EXPECT_TRUE(s1.contains("happy"));
+    EXPECT_FALSE(s1.contains("today"));
+    EXPECT_EQ(3, s1.size());
+}
+
+
+TEST(RcuHashSet_SanityCheckTests, growsAndRemoves)
+{
+    RcuHashSet<int, DefaultHasher<int>> s1;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s1.add(i);
+    }
+
+    EXPECT_EQ(1000, s1.size());
+    EXPECT_GE(s1.bucketCount() * 0.8, 1000);
+
+    for (int i = 0; i < 1000; i += 2)
+    {
+        s1.remove(i);
+    }
+    s1.remove(0);
+
+    EXPECT_EQ(500, s1.size());
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(i % 2 == 1, s1.contains(i));
+    }
+}
+
+
+TEST(RcuHashSet_SanityCheckTests, readersSeeStableElementsWhileWriterChangesOthers)
+{
+    RcuHashSet<int, DefaultHasher<int>> s1;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s1.add(i);
+    }
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+
+    // The writer grows the set many times and removes what it added, while
+    // the readers check that the original elements never go missing (and
+    // that the array they're searching is never freed while they read it).
+    for (int t = 0; t < 4; ++t)
+    {
+        readers.emplace_back([&]() {
+            while (!done.load())
+            {
+                for (int i = 0; i < 100; ++i)
+                {
+                    EXPECT_TRUE(s1.contains(i));
+                }
+                EXPECT_FALSE(s1.contains(-1));
+                EXPECT_GE(s1.bucketCount(), 16);
+            }
+        });
+    }
+
+    for (int i = 100; i < 5000; ++i)
+    {
+        s1.add(i);
+        if (i % 3 == 0)
+        {
+            s1.remove(i);
+        }
+    }
+
+    done.store(true);
+
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_EQ(100 + 4900 - 1633, s1.size());
+}
@@ -0,0 +1,129 @@
+#include <string>
+#include <gtest/gtest.h>
+#include "RobinHoodHashSet.hpp"
+
+
+namespace
+{
+    template <typename T>
+    unsigned int zeroHash(const T&)
+    {
+        return 0;
+    }
+
+
+    unsigned int identityHash(const int& i)
+    {
+        return i;
+    }
+}
+
+
+TEST(RobinHoodHashSet_SanityCheckTests, canBeUsedThroughSet)
+{
+    // With every element hashing to the same slot, each one that's added
+    // lands further from home, and searches have to probe past the others.
+    RobinHoodHashSet<int> s1{zeroHash<int>};
+    Set<int>& ss1 = s1;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        ss1.add(i);
+    }
+
+    EXPECT_EQ(10, ss1.size());
+    EXPECT_TRUE(ss1.contains(0));
+    EXPECT_TRUE(ss1.contains(9));
+    EXPECT_FALSE(ss1.contains(10));
+}
+
+
+TEST(RobinHoodHashSet_SanityCheckTests, canCopyAndMove)
+{
+    RobinHoodHashSet<std::string> s1{zeroHash<std::string>};
+    s1.add("HELLO");
+
+    RobinHoodHashSet<std::string> s1Copy{s1};
+    RobinHoodHashSet<std::string> s1Moved{std::move(s1)};
+
+    EXPECT_TRUE(s1Copy.contains("HELLO"));
+    EXPECT_TRUE(s1Moved.contains("HELLO"));
+
+    RobinHoodHashSet<std::string> s2{zeroHash<std::string>};
+    s2 = s1Copy;
+    EXPECT_TRUE(s2.contains("HELLO"));
+    EXPECT_EQ(1, s2.size());
+}
+
+
+TEST(RobinHoodHashSet_SanityCheckTests, containsElementsAfterAdding)
+{
+    RobinHoodHashSet<int> s1{zeroHash<int>};
+    s1.add(11);
+    s1.add(1);
+    s1.add(5);
+    s1.add(11);
+
+    EXPECT_TRUE(s1.contains(11));
+    EXPECT_TRUE(s1.contains(1));
+    EXPECT_TRUE(s1.contains(5));
+    EXPECT_FALSE(s1.contains(21));
+    EXPECT_EQ(3, s1.size());
+}
+
+
+TEST(RobinHoodHashSet_SanityCheckTests, containsElementsAfterResizing)
+{
+    RobinHoodHashSet<int> s1{identityHash};
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s1.add(i * 7);
+    }
+
+    EXPECT_EQ(1000, s1.size());
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(s1.contains(i * 7));
+        EXPECT_FALSE(s1.contains(i * 7 + 1));
+    }
+}
+
+
+TEST(RobinHoodHashSet_SanityCheckTests, elementsAtIndexAccordingToHash)
+{
+    RobinHoodHashSet<int> s1{zeroHash<int>};
+    s1.add(11);
+    s1.add(1);
+    s1.add(5);
+
+    EXPECT_EQ(3, s1.elementsAtIndex(0));
+    EXPECT_EQ(0, s1.elementsAtIndex(1));
+
+    EXPECT_TRUE(s1.isElementAtIndex(11, 0));
+    EXPECT_TRUE(s1.isElementAtIndex(1, 0));
+    EXPECT_TRUE(s1.isElementAtIndex(5, 0));
+
+    EXPECT_FALSE(s1.isElementAtIndex(11, 1));
+    EXPECT_FALSE(s1.isElementAtIndex(1, 1));
+    EXPECT_FALSE(s1.isElementAtIndex(5, 1));
+}
+
+
+TEST(RobinHoodHashSet_SanityCheckTests, removeShiftsProbeSequenceBack)
+{
+    RobinHoodHashSet<int> s1{zeroHash<int>};
+    s1.add(11);
+    s1.add(1);
+    s1.add(5);
+
+    s1.remove(1);
+    s1.remove(21);
+
+    EXPECT_EQ(2, s1.size());
+    EXPECT_EQ(2, s1.elementsAtIndex(0));
+    EXPECT_TRUE(s1.contains(11));
+    EXPECT_FALSE(s1.contains(1));
+    EXPECT_TRUE(s1.contains(5));
+}
@@ -0,0 +1,132 @@
+#include <string>
+#include <gtest/gtest.h>
+#include "SwissHashSet.hpp"
+
+
+namespace
+{
+    template <typename T>
+    unsigned int zeroHash(const T&)
+    {
+        return 0;
+    }
+
+
+    unsigned int identityHash(const int& i)
+    {
+        return i;
+    }
+}
+
+
+TEST(SwissHashSet_SanityCheckTests, canBeUsedThroughSet)
+{
+    // More colliding elements than fit in one group, so that both adding
+    // and searching have to probe into the next group.
+    SwissHashSet<int> s1{zeroHash<int>};
+    Set<int>& ss1 = s1;
+    int count = SwissHashSet<int>::GROUP_WIDTH + 4;
+
+    for (int i = 0; i < count; ++i)
+    {
+        ss1.add(i);
+    }
+
+    EXPECT_EQ(count, ss1.size());
+    EXPECT_TRUE(ss1.contains(count - 1));
+    EXPECT_FALSE(ss1.contains(count));
+}
+
+
+TEST(SwissHashSet_SanityCheckTests, canCopyAndMove)
+{
+    SwissHashSet<std::string> s1{zeroHash<std::string>};
+    s1.add("HELLO");
+
+    SwissHashSet<std::string> s1Copy{s1};
+    SwissHashSet<std::string> s1Moved{std::move(s1)};
+
+    EXPECT_TRUE(s1Copy.contains("HELLO"));
+    EXPECT_TRUE(s1Moved.contains("HELLO"));
+
+    SwissHashSet<std::string> s2{zeroHash<std::string>};
+    s2 = s1Copy;
+    EXPECT_TRUE(s2.contains("HELLO"));
+    EXPECT_EQ(1, s2.size());
+}
+
+
+TEST(SwissHashSet_SanityCheckTests, containsElementsAfterAdding)
+{
+    SwissHashSet<int> s1{zeroHash<int>};
+    s1.add(11);
+    s1.add(1);
+    s1.add(5);
+    s1.add(11);
+
+    EXPECT_TRUE(s1.contains(11));
+    EXPECT_TRUE(s1.contains(1));
+    EXPECT_TRUE(s1.contains(5));
+    EXPECT_FALSE(s1.contains(21));
+    EXPECT_EQ(3, s1.size());
+}
+
+
+TEST(SwissHashSet_SanityCheckTests, containsElementsAfterResizing)
+{
+    SwissHashSet<int> s1{identityHash};
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s1.add(i * 7);
+    }
+
+    EXPECT_EQ(1000, s1.size());
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(s1.contains(i * 7));
+        EXPECT_FALSE(s1.contains(i * 7 + 1));
+    }
+}
+
+
+TEST(SwissHashSet_SanityCheckTests, elementsAtIndexAccordingToHash)
+{
+    SwissHashSet<int> s1{zeroHash<int>};
+    s1.add(11);
+    s1.add(1);
+    s1.add(5);
+
+    EXPECT_EQ(3, s1.elementsAtIndex(0));
+    EXPECT_EQ(0, s1.elementsAtIndex(1));
+
+    EXPECT_TRUE(s1.isElementAtIndex(11, 0));
+    EXPECT_TRUE(s1.isElementAtIndex(1, 0));
+    EXPECT_TRUE(s1.isElementAtIndex(5, 0));
+
+    EXPECT_FALSE(s1.isElementAtIndex(11, 1));
+    EXPECT_FALSE(s1.isElementAtIndex(1, 1));
+    EXPECT_FALSE(s1.isElementAtIndex(5, 1));
+}
+
+
+TEST(SwissHashSet_SanityCheckTests, probesPastFullGroups)
+{
+    SwissHashSet<int> s1{zeroHash<int>};
+
+    for (int i = 0; i < 100; ++i)
+    {
+        s1.add(i);
+    }
+
+    EXPECT_EQ(100, s1.size());
+    EXPECT_EQ(100, s1.elementsAtIndex(0));
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(s1.contains(i));
+    }
+
+    EXPECT_FALSE(s1.contains(100));
+}